@@ -0,0 +1,107 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include <benchmark/benchmark.h>
+
+namespace infini
+{
+    namespace
+    {
+        // A residual-style chain of n operators: Relu, then Add of the Relu
+        // and the previous activation, repeated.
+        Graph buildChain(int n)
+        {
+            Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+            Tensor x = g->addTensor(Shape{4, 16});
+            for (int i = 0; i < n / 2; ++i)
+            {
+                auto relu = g->addOp<ReluObj>(x, nullptr);
+                x = g->addOp<AddObj>(relu->getOutput(), x, nullptr)->getOutput();
+            }
+            return g;
+        }
+
+        void graphArgs(benchmark::internal::Benchmark *b)
+        {
+            b->RangeMultiplier(4)->Range(1 << 10, 1 << 16)->Complexity();
+        }
+    } // namespace
+
+    void BM_GraphBuild(benchmark::State &state)
+    {
+        for (auto _ : state)
+            benchmark::DoNotOptimize(buildChain(state.range(0)));
+        state.SetComplexityN(state.range(0));
+    }
+    BENCHMARK(BM_GraphBuild)->Apply(graphArgs);
+    // Independent graphs built on several threads at once, as when models
+    // load at startup.
+    BENCHMARK(BM_GraphBuild)->Arg(1 << 12)->ThreadRange(1, 8)->UseRealTime();
+
+    void BM_GraphCheckValid(benchmark::State &state)
+    {
+        Graph g = buildChain(state.range(0));
+        for (auto _ : state)
+            benchmark::DoNotOptimize(g->checkValid());
+        state.SetComplexityN(state.range(0));
+    }
+    BENCHMARK(BM_GraphCheckValid)->Apply(graphArgs);
+
+    void BM_GraphShapeInfer(benchmark::State &state)
+    {
+        Graph g = buildChain(state.range(0));
+        for (auto _ : state)
+            g->shape_infer();
+        state.SetComplexityN(state.range(0));
+    }
+    BENCHMARK(BM_GraphShapeInfer)->Apply(graphArgs);
+
+    // Removes every other Relu's output from the index, then compacts.
+    void BM_GraphRemove(benchmark::State &state)
+    {
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            Graph g = buildChain(state.range(0));
+            TensorVec victims;
+            for (auto &t : g->getTensors())
+                if (t->getFuid() % 2)
+                    victims.emplace_back(t);
+            state.ResumeTiming();
+            for (auto &t : victims)
+                g->removeTensor(t);
+            benchmark::DoNotOptimize(g->getTensors().size());
+        }
+        state.SetComplexityN(state.range(0));
+    }
+    BENCHMARK(BM_GraphRemove)->Apply(graphArgs);
+
+    // Default pipeline on a chain where every Relu is wrapped in a pair of
+    // inverse transposes, all of which cancel.
+    void BM_GraphOptimize(benchmark::State &state)
+    {
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+            Tensor x = g->addTensor(Shape{4, 16});
+            for (int i = 0; i < state.range(0) / 3; ++i)
+            {
+                auto t0 = g->addOp<TransposeObj>(x, nullptr, vector<int>{1, 0});
+                auto t1 = g->addOp<TransposeObj>(t0->getOutput(), nullptr,
+                                                 vector<int>{1, 0});
+                x = g->addOp<ReluObj>(t1->getOutput(), nullptr)->getOutput();
+            }
+            state.ResumeTiming();
+            g->optimize();
+        }
+        state.SetComplexityN(state.range(0));
+    }
+    BENCHMARK(BM_GraphOptimize)->Apply(graphArgs);
+
+} // namespace infini
+
+BENCHMARK_MAIN();
@@ -0,0 +1,337 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include "utils/data_generator.h"
+
+#include <benchmark/benchmark.h>
+
+namespace infini
+{
+    namespace
+    {
+        // One runtime per thread count, so pools aren't rebuilt per case.
+        // Cases use wall time since the kernels run on the pool threads.
+        Runtime getRuntime(int threads)
+        {
+            static std::map<int, Runtime> runtimes;
+            auto &runtime = runtimes[threads];
+            if (!runtime)
+            {
+                ThreadPoolConfig config = ThreadPoolConfig::fromEnv();
+                config.numThreads = threads;
+                runtime = make_ref<NativeCpuRuntimeObj>(config);
+            }
+            return runtime;
+        }
+
+        int maxThreads()
+        {
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // Runs the single-operator graph built by `build` and reports its
+        // analytic FLOPs and bytes as rates.
+        template <typename Build>
+        void runOp(benchmark::State &state, int threads, Build &&build)
+        {
+            auto runtime = getRuntime(threads);
+            Graph g = make_ref<GraphObj>(runtime);
+            Operator op = build(g);
+            g->dataMalloc();
+            for (auto &input : g->getInputs())
+                input->setData(IncrementalGenerator());
+            for (auto _ : state)
+                runtime->run(g);
+            auto cost = op->getCost();
+            state.counters["threads"] = threads;
+            state.counters["bytes"] = benchmark::Counter(
+                double(cost.bytes) * state.iterations(),
+                benchmark::Counter::kIsRate, benchmark::Counter::kIs1024);
+            if (cost.flops)
+                state.counters["FLOPS"] = benchmark::Counter(
+                    double(cost.flops) * state.iterations(),
+                    benchmark::Counter::kIsRate);
+        }
+
+        // Runs the graph built by `build`, which returns the number of
+        // output elements, after the default optimisations and load-time
+        // constant folding and packing if `optimize`.
+        template <typename Build>
+        void runGraph(benchmark::State &state, int threads, bool optimize,
+                      Build &&build)
+        {
+            auto runtime = getRuntime(threads);
+            Graph g = make_ref<GraphObj>(runtime);
+            int64_t items = build(g);
+            if (optimize)
+                g->optimize();
+            g->dataMalloc();
+            for (auto &input : g->getInputs())
+                input->setData(IncrementalGenerator());
+            if (optimize)
+            {
+                g->foldConstants();
+                g->packConstants();
+            }
+            for (auto _ : state)
+                runtime->run(g);
+            state.counters["threads"] = threads;
+            state.counters["ops"] = g->getOperators().size();
+            state.SetItemsProcessed(items * state.iterations());
+        }
+
+        // Element counts x thread counts.
+        void elementArgs(benchmark::internal::Benchmark *b)
+        {
+            for (int threads : {1, 2, 4, maxThreads()})
+                for (int64_t n : {1 << 10, 1 << 16, 1 << 20, 1 << 24})
+                    b->Args({n, threads});
+        }
+
+        void matmulArgs(benchmark::internal::Benchmark *b)
+        {
+            for (int threads : {1, 4, maxThreads()})
+                for (int64_t n : {64, 256, 1024})
+                    b->Args({n, threads});
+        }
+    } // namespace
+
+    template <class T> void BM_ElementWise(benchmark::State &state)
+    {
+        int n = state.range(0);
+        runOp(state, state.range(1), [&](Graph &g)
+              { return g->addOp<T>(g->addTensor(Shape{n}),
+                                   g->addTensor(Shape{n}), nullptr); });
+    }
+
+    // A [n / 256, 256] operand with a [256] row broadcast over it.
+    template <class T> void BM_ElementWiseBroadcast(benchmark::State &state)
+    {
+        int n = state.range(0);
+        runOp(state, state.range(1), [&](Graph &g)
+              { return g->addOp<T>(g->addTensor(Shape{n / 256, 256}),
+                                   g->addTensor(Shape{256}), nullptr); });
+    }
+
+    BENCHMARK_TEMPLATE(BM_ElementWise, AddObj)
+        ->Apply(elementArgs)
+        ->UseRealTime();
+    BENCHMARK_TEMPLATE(BM_ElementWise, SubObj)
+        ->Apply(elementArgs)
+        ->UseRealTime();
+    BENCHMARK_TEMPLATE(BM_ElementWise, MulObj)
+        ->Apply(elementArgs)
+        ->UseRealTime();
+    BENCHMARK_TEMPLATE(BM_ElementWise, DivObj)
+        ->Apply(elementArgs)
+        ->UseRealTime();
+    BENCHMARK_TEMPLATE(BM_ElementWiseBroadcast, AddObj)
+        ->Apply(elementArgs)
+        ->UseRealTime();
+    BENCHMARK_TEMPLATE(BM_ElementWiseBroadcast, SubObj)
+        ->Apply(elementArgs)
+        ->UseRealTime();
+    BENCHMARK_TEMPLATE(BM_ElementWiseBroadcast, MulObj)
+        ->Apply(elementArgs)
+        ->UseRealTime();
+    BENCHMARK_TEMPLATE(BM_ElementWiseBroadcast, DivObj)
+        ->Apply(elementArgs)
+        ->UseRealTime();
+
+    void BM_Relu(benchmark::State &state)
+    {
+        int n = state.range(0);
+        runOp(state, state.range(1), [&](Graph &g)
+              { return g->addOp<ReluObj>(g->addTensor(Shape{n}), nullptr); });
+    }
+    BENCHMARK(BM_Relu)
+        ->Apply(elementArgs)
+        ->UseRealTime();
+
+    void BM_Clip(benchmark::State &state)
+    {
+        int n = state.range(0);
+        runOp(state, state.range(1), [&](Graph &g)
+              { return g->addOp<ClipObj>(g->addTensor(Shape{n}), nullptr,
+                                         10.f, 1000.f); });
+    }
+    BENCHMARK(BM_Clip)
+        ->Apply(elementArgs)
+        ->UseRealTime();
+
+    void BM_Cast(benchmark::State &state)
+    {
+        int n = state.range(0);
+        runOp(state, state.range(1), [&](Graph &g)
+              { return g->addOp<CastObj>(g->addTensor(Shape{n}), nullptr,
+                                         CastType::Float2Int32); });
+    }
+    BENCHMARK(BM_Cast)
+        ->Apply(elementArgs)
+        ->UseRealTime();
+
+    // Add(bias) -> Relu -> Clip -> Cast over n elements, run op by op
+    // (range(2) == 0) or as the single region the optimizer fuses it into.
+    void BM_ElementWiseChain(benchmark::State &state)
+    {
+        int n = state.range(0);
+        runGraph(state, state.range(1), state.range(2), [&](Graph &g)
+                 {
+                     auto x = g->addTensor(Shape{n / 64, 64});
+                     auto add = g->addOp<AddObj>(x, g->addTensor(Shape{64}),
+                                                 nullptr);
+                     auto relu = g->addOp<ReluObj>(add->getOutput(), nullptr);
+                     auto clip = g->addOp<ClipObj>(relu->getOutput(), nullptr,
+                                                   10.f, 1000.f);
+                     g->addOp<CastObj>(clip->getOutput(), nullptr,
+                                       CastType::Float2Int32);
+                     return n; });
+    }
+    BENCHMARK(BM_ElementWiseChain)
+        ->ArgsProduct(
+            {{1 << 16, 1 << 20, 1 << 24}, {1, maxThreads()}, {0, 1}})
+        ->UseRealTime();
+
+    // range(0) selects the permutation of a [n / 4096, 16, 256] tensor.
+    void BM_Transpose(benchmark::State &state)
+    {
+        static const vector<vector<int>> perms{
+            {0, 2, 1}, {2, 1, 0}, {1, 0, 2}};
+        const auto &perm = perms[state.range(0)];
+        int n = state.range(1);
+        state.SetLabel("perm=" + vecToString(perm));
+        runOp(state, state.range(2), [&](Graph &g)
+              { return g->addOp<TransposeObj>(
+                    g->addTensor(Shape{n / 4096, 16, 256}), nullptr, perm); });
+    }
+    BENCHMARK(BM_Transpose)
+        ->ArgsProduct({{0, 1, 2}, {1 << 16, 1 << 20, 1 << 24}, {1, 4}})
+        ->UseRealTime();
+
+    // Four equal [n / 4096, 16, 64] inputs concatenated on axis range(0).
+    void BM_Concat(benchmark::State &state)
+    {
+        int axis = state.range(0), n = state.range(1);
+        runOp(state, state.range(2), [&](Graph &g)
+              {
+            TensorVec inputs;
+            for (int i = 0; i < 4; ++i)
+                inputs.emplace_back(g->addTensor(Shape{n / 4096, 16, 64}));
+            return g->addOp<ConcatObj>(inputs, nullptr, axis); });
+    }
+    BENCHMARK(BM_Concat)
+        ->ArgsProduct({{0, 1, 2}, {1 << 16, 1 << 20, 1 << 24}, {1, 4}})
+        ->UseRealTime();
+
+    void BM_MatmulSquare(benchmark::State &state)
+    {
+        int n = state.range(0);
+        runOp(state, state.range(1), [&](Graph &g)
+              { return g->addOp<MatmulObj>(g->addTensor(Shape{n, n}),
+                                           g->addTensor(Shape{n, n}), nullptr); });
+    }
+    BENCHMARK(BM_MatmulSquare)
+        ->Apply(matmulArgs)
+        ->UseRealTime();
+
+    // Inference-style [n, 4096] x [4096, 64] with a short activation side.
+    void BM_MatmulSkinny(benchmark::State &state)
+    {
+        int n = state.range(0);
+        runOp(state, state.range(1), [&](Graph &g)
+              { return g->addOp<MatmulObj>(g->addTensor(Shape{n / 16, 4096}),
+                                           g->addTensor(Shape{4096, 64}),
+                                           nullptr); });
+    }
+    BENCHMARK(BM_MatmulSkinny)
+        ->Apply(matmulArgs)
+        ->UseRealTime();
+
+    // 16 batches of [n, 64] x [64, n] with the transposed weight layout.
+    void BM_MatmulBatched(benchmark::State &state)
+    {
+        int n = state.range(0);
+        runOp(state, state.range(1), [&](Graph &g)
+              { return g->addOp<MatmulObj>(g->addTensor(Shape{16, n, 64}),
+                                           g->addTensor(Shape{16, n, 64}),
+                                           nullptr, false, true); });
+    }
+    BENCHMARK(BM_MatmulBatched)
+        ->Apply(matmulArgs)
+        ->UseRealTime();
+
+    // [n, n] x [n, n] -> Add(bias) -> Relu, as three ops (range(2) == 0) or
+    // one MatMul with the rest in its epilogue.
+    void BM_MatmulEpilogue(benchmark::State &state)
+    {
+        int n = state.range(0);
+        runGraph(state, state.range(1), state.range(2), [&](Graph &g)
+                 {
+                     auto mm = g->addOp<MatmulObj>(g->addTensor(Shape{n, n}),
+                                                   g->addTensor(Shape{n, n}),
+                                                   nullptr);
+                     auto add = g->addOp<AddObj>(mm->getOutput(),
+                                                 g->addTensor(Shape{n}),
+                                                 nullptr);
+                     g->addOp<ReluObj>(add->getOutput(), nullptr);
+                     return int64_t(n) * n; });
+    }
+    BENCHMARK(BM_MatmulEpilogue)
+        ->ArgsProduct({{64, 256, 1024}, {1, maxThreads()}, {0, 1}})
+        ->UseRealTime();
+
+    // Q/K/V-style projections of an [n, 256] activation by three constant
+    // [256, 256] weights, as three MatMuls (range(2) == 0) or one.
+    void BM_SiblingMatmuls(benchmark::State &state)
+    {
+        int n = state.range(0);
+        runGraph(state, state.range(1), state.range(2), [&](Graph &g)
+                 {
+                     Tensor x = g->addTensor(Shape{n, 256});
+                     for (int i = 0; i < 3; ++i)
+                     {
+                         Tensor w = g->addTensor(Shape{256, 256});
+                         w->setConstant();
+                         g->addOp<MatmulObj>(x, w, nullptr);
+                     }
+                     return int64_t(3) * n * 256; });
+    }
+    BENCHMARK(BM_SiblingMatmuls)
+        ->ArgsProduct({{1, 16, 256}, {1, maxThreads()}, {0, 1}})
+        ->UseRealTime();
+
+    // [n, n] x constant [n, n] weight, transposed if range(2) & 1, with the
+    // weight packed at load time if range(2) & 2.
+    void BM_MatmulPackedWeight(benchmark::State &state)
+    {
+        int n = state.range(0), threads = state.range(1);
+        bool transB = state.range(2) & 1, pack = state.range(2) & 2;
+        auto runtime = getRuntime(threads);
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor w = g->addTensor(Shape{n, n});
+        w->setConstant();
+        auto op = g->addOp<MatmulObj>(g->addTensor(Shape{n, n}), w, nullptr,
+                                      false, transB);
+        g->dataMalloc();
+        for (auto &input : g->getInputs())
+            input->setData(IncrementalGenerator());
+        if (pack)
+            g->packConstants();
+        for (auto _ : state)
+            runtime->run(g);
+        state.counters["threads"] = threads;
+        state.counters["FLOPS"] = benchmark::Counter(
+            double(op->getCost().flops) * state.iterations(),
+            benchmark::Counter::kIsRate);
+    }
+    BENCHMARK(BM_MatmulPackedWeight)
+        ->ArgsProduct({{64, 256, 1024}, {1, maxThreads()}, {0, 1, 2, 3}})
+        ->UseRealTime();
+
+} // namespace infini
+
+BENCHMARK_MAIN();
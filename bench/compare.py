@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""Compares a Google Benchmark JSON run against a stored baseline.
+
+Both files come from `bench_kernels --benchmark_out=<file>
+--benchmark_out_format=json --benchmark_repetitions=<n>`. A benchmark is a
+regression when its median wall time grew by more than --threshold and a
+Mann-Whitney U test over the repetitions says the shift is not noise. The
+exit status is 1 when any benchmark regressed, so CI can gate on it.
+"""
+
+import argparse
+import json
+import math
+import statistics
+import sys
+
+# Context fields that must match for timings to be comparable.
+MACHINE_KEYS = ("host_name", "num_cpus", "mhz_per_cpu", "library_build_type")
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    times = {}
+    for b in data["benchmarks"]:
+        # Aggregates (mean, median, ...) are recomputed from the repetitions.
+        if b.get("run_type", "iteration") != "iteration" or "error_occurred" in b:
+            continue
+        name = b.get("run_name", b["name"])
+        time = b["real_time"] * {"ns": 1, "us": 1e3, "ms": 1e6, "s": 1e9}[
+            b.get("time_unit", "ns")]
+        times.setdefault(name, []).append(time)
+    return data.get("context", {}), times
+
+
+def mann_whitney_p(xs, ys):
+    """Two-sided p-value of the Mann-Whitney U test, normal approximation
+    with tie correction. Needs a few repetitions per side to mean much."""
+    n1, n2 = len(xs), len(ys)
+    values = sorted([(v, 0) for v in xs] + [(v, 1) for v in ys])
+    ranks, ties, i = [0.0] * len(values), 0.0, 0
+    while i < len(values):
+        j = i
+        while j + 1 < len(values) and values[j + 1][0] == values[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2 + 1
+        ties += (j - i + 1) ** 3 - (j - i + 1)
+        i = j + 1
+    r1 = sum(r for r, (_, side) in zip(ranks, values) if side == 0)
+    u = r1 - n1 * (n1 + 1) / 2
+    n = n1 + n2
+    var = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)))
+    if var <= 0:
+        return 1.0
+    z = (abs(u - n1 * n2 / 2) - 0.5) / math.sqrt(var)
+    return math.erfc(max(z, 0) / math.sqrt(2))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("contender")
+    parser.add_argument("--threshold", type=float, default=0.1,
+                        help="relative slowdown of the median that fails "
+                             "(default: 0.1 = 10%%)")
+    parser.add_argument("--alpha", type=float, default=0.05,
+                        help="significance level of the noise check")
+    parser.add_argument("--filter", default="",
+                        help="only compare benchmarks containing this string")
+    args = parser.parse_args()
+
+    base_ctx, base = load(args.baseline)
+    new_ctx, new = load(args.contender)
+    for key in MACHINE_KEYS:
+        if base_ctx.get(key) != new_ctx.get(key):
+            print("warning: %s differs (%s vs %s), timings may not be "
+                  "comparable" % (key, base_ctx.get(key), new_ctx.get(key)),
+                  file=sys.stderr)
+
+    regressions = 0
+    width = max([len(n) for n in new] + [9])
+    print("%-*s %12s %12s %8s %8s  %s" % (width, "Benchmark", "Base(ns)",
+                                         "New(ns)", "Change", "p", "Status"))
+    for name in sorted(set(base) & set(new)):
+        if args.filter not in name:
+            continue
+        b, n = statistics.median(base[name]), statistics.median(new[name])
+        change = n / b - 1
+        p = mann_whitney_p(base[name], new[name])
+        significant = p < args.alpha
+        if change > args.threshold and significant:
+            status = "REGRESSION"
+            regressions += 1
+        elif change < -args.threshold and significant:
+            status = "faster"
+        elif abs(change) > args.threshold:
+            status = "noise"
+        else:
+            status = ""
+        print("%-*s %12.0f %12.0f %+7.1f%% %8.3f  %s" %
+              (width, name, b, n, change * 100, p, status))
+    for name in sorted(set(base) ^ set(new)):
+        print("%-*s only in %s" % (width, name,
+                                   "baseline" if name in base else "contender"))
+
+    reps = [len(v) for v in list(base.values()) + list(new.values())]
+    if reps and min(reps) < 5:
+        print("warning: fewer than 5 repetitions, the noise check can hardly "
+              "reject; run with --benchmark_repetitions", file=sys.stderr)
+    print("%d regression(s) above %.0f%%" % (regressions, args.threshold * 100))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -15,6 +15,8 @@ private:
     Runtime runtime;
     size_t used;
     size_t peak;
+    // End of the highest block in use; blocks past it are never kept free.
+    size_t top;
     size_t alignment;
     void *ptr;
 
@@ -30,9 +32,48 @@ public:
     size_t alloc(size_t size);
     void free(size_t addr, size_t size);
     void *getPtr();
+    // Bytes getPtr allocates: the highest end of a block so far.
+    size_t getPeak() const { return peak; }
     void info();
 
 private:
     size_t getAlignedSize(size_t size);
 };
+
+/**
+ * @brief Memory holding the intermediate tensors of the graphs bound to it,
+ * as large as the largest of their plans. Intermediates carry no data from
+ * one run to the next, so graphs that do not run at the same time can share
+ * one arena (see GraphObj::setArena).
+ */
+class ArenaObj
+{
+private:
+    Runtime runtime;
+    void *ptr = nullptr;
+    size_t size = 0;
+    // Bumped whenever `ptr` changes, so that graphs know to bind again.
+    size_t generation = 0;
+
+public:
+    explicit ArenaObj(Runtime runtime) : runtime(std::move(runtime)) {}
+    ArenaObj(const ArenaObj &) = delete;
+    ArenaObj &operator=(const ArenaObj &) = delete;
+    ~ArenaObj() { reset(); }
+
+    /**
+     * @brief Grows the arena to at least `bytes` and returns its base.
+     * Growing moves it; graphs bound to it bind again before their next run.
+     */
+    void *reserve(size_t bytes);
+    /**
+     * @brief Frees the memory, e.g. while the graphs using it are idle.
+     * They reserve it again before their next run.
+     */
+    void reset();
+    size_t getSize() const { return size; }
+    size_t getGeneration() const { return generation; }
+};
+
+using Arena = Ref<ArenaObj>;
 }
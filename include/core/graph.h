@@ -4,59 +4,156 @@
 #include "core/tensor.h"
 #include <algorithm>
 #include <cstdint>
+#include <map>
+#include <unordered_map>
 
 namespace infini
 {
 
+    /**
+     * @brief Operators and the tensors connecting them. Independent graphs
+     * share no mutable state, so they can be built, optimised, planned and
+     * run on different threads at the same time; one graph is not safe to
+     * change from several threads, while its const members may be called
+     * from several. To run one graph concurrently, see SessionObj.
+     */
     class GraphObj : public Object
     {
     protected:
         Runtime runtime;
+        // Every call that removes nodes compacts `tensors`/`ops` once before
+        // returning, so that const accessors never write and a finished
+        // graph may be read from several threads.
         TensorVec tensors;
         OpVec ops;
-        Allocator allocator;
 
     public:
         explicit GraphObj(Runtime runtime)
-            : runtime(runtime), allocator(runtime), sorted(false){};
+            : runtime(runtime), sorted(true){};
         string toString() const override;
         Runtime getRuntime() const { return runtime; }
 
         Tensor addTensor(Shape dim, DataType dtype = DataType::Float32);
         Tensor addTensor(const Tensor &tensor);
         TensorVec addTensor(const TensorVec &tensors);
-        void removeOperator(Operator op)
-        {
-            auto it = std::find(ops.begin(), ops.end(), op);
-            if (it != ops.end())
-                ops.erase(it);
-        }
-
-        void removeTensor(Tensor tensor)
-        {
-            auto it = std::find(tensors.begin(), tensors.end(), tensor);
-            if (it != tensors.end())
-                tensors.erase(it);
-        }
+        void removeOperator(Operator op);
+        void removeTensor(Tensor tensor);
 
         const TensorVec &getTensors() const { return tensors; }
         const OpVec &getOperators() const { return ops; }
-        Tensor getTensor(int) const;
+        /**
+         * @brief Gets the tensor with the given fuid, or nullptr.
+         */
+        Tensor getTensor(int fuid) const;
+        bool hasTensor(const Tensor &tensor) const;
+        bool hasOperator(const Operator &op) const;
+        bool hasOperator(const OperatorObj *op) const;
 
         /**
          * @brief Sort the nodes in topological order.
          * It returns true if the sorting is successful.
          * Otherwise false is returned, means that there are rings in the graph,
          * so the topological sorting fails.
+         * Adding operators and replacing inputs through the graph keep the
+         * order up to date, so this only sorts again after a failure or an
+         * edit made behind the graph's back.
          */
         bool topo_sort();
 
+        /**
+         * @brief Makes `op` read `newInput` instead of `oldInput`, updating
+         * tensor targets, operator links and the topological order.
+         */
+        void replaceInput(const Operator &op, const Tensor &oldInput,
+                          const Tensor &newInput);
+        /**
+         * @brief Removes `op`, whose outputs must have no consumers, and its
+         * outputs. Inputs left without consumers are removed as well, along
+         * with their producers once none of those producers' outputs is used.
+         */
+        void eraseOperator(const Operator &op);
+
+        /**
+         * @brief Puts `replacement`, which is not in the graph yet and writes
+         * the same output tensors, in place of `op`. `op` is erased like in
+         * eraseOperator, but its outputs stay with their consumers.
+         */
+        void replaceOperator(const Operator &op, const Operator &replacement);
+
+        /**
+         * @brief Runs the default pass pipeline (PassManager::createDefault).
+         */
         void optimize();
 
         void shape_infer();
 
+        /**
+         * @brief Binds every tensor to memory. Constants, e.g. weights, are
+         * placed once in a region of their own and keep their data. The other
+         * tensors follow a plan made for the current shapes of the inputs
+         * that are not constant: graph inputs and outputs get buffers of the
+         * plan, and intermediates share the activation arena, reusing the
+         * space of tensors whose last reader ran. Plans are cached by those
+         * shapes, so going back to shapes seen before rebinds their buffers
+         * without planning. The graph must not gain tensors after the first
+         * call.
+         */
         void dataMalloc();
 
+        /**
+         * @brief Gives the graph inputs `inputs`, which must not be
+         * constant, the shapes `dims`, infers the other shapes again and
+         * binds the memory plan of the new shapes (see dataMalloc). Inputs
+         * must be filled again afterwards. Lets one graph serve requests of
+         * varying batch size or sequence length; pad_to_bucket bounds the
+         * number of plans kept.
+         */
+        void resize(const TensorVec &inputs, const vector<Shape> &dims);
+        size_t getPlanCount() const { return plans.size(); }
+
+        /**
+         * @brief Places the intermediates in `arena`, which graphs that do
+         * not run at the same time may share. Call before dataMalloc.
+         */
+        void setArena(Arena arena);
+        Arena getArena() const { return arena; }
+        /**
+         * @brief Binds the intermediates again if the arena moved since they
+         * were bound, e.g. because another graph grew it. Runtimes call this
+         * before running the graph.
+         */
+        void bindActivations();
+
+        /**
+         * @brief Runs every operator whose inputs and outputs are all
+         * constant once with the runtime's kernels and removes it; its
+         * outputs become constant graph inputs holding the results, and
+         * constants read by nothing else are dropped. Operators added before
+         * their inputs were marked constant after dataMalloc, and those
+         * writing graph outputs, keep running. Then the load-time patterns, which read
+         * constant values (e.g. to drop an Add of zeros), run. Call after
+         * dataMalloc once the constant inputs hold their data. Returns the
+         * number of operators folded.
+         */
+        size_t foldConstants();
+
+        /**
+         * @brief Lets the kernel of every operator store its constant inputs
+         * in the layout it reads fastest, e.g. MatMul weights in packed
+         * panels, so that runs skip the conversion. Call after foldConstants.
+         * Returns the number of operators whose inputs were packed.
+         */
+        size_t packConstants();
+
+        /**
+         * @brief Copies the graph for another thread to run (see SessionObj).
+         * The copy's constants share this graph's buffers; its other tensors
+         * are bound by its own dataMalloc. Call after the constants are
+         * loaded, folded and packed; they must not change while copies
+         * exist.
+         */
+        Graph cloneWithSharedWeights() const;
+
         /**
          * @brief Add an operator and create its outputs. Output tensor arguments
          * should be empty Refs (e.g., nullptr).
@@ -80,14 +177,20 @@ namespace infini
             return op;
         }
 
+        /**
+         * @brief Adds a copy of `op` that reads `inputs` and writes new
+         * tensors; attributes such as a Transpose permutation are kept.
+         */
+        Operator cloneOperator(const Operator &op, const TensorVec &inputs);
+
         /**
          * @brief Gets input tensors of this graph.
          */
         inline TensorVec getInputs() const
         {
             TensorVec ret;
-            for (const auto &t : tensors)
-                if (!t->getSource())
+            for (const auto &t : getTensors())
+                if (!t->getSourcePtr())
                     ret.emplace_back(t);
             return ret;
         }
@@ -98,8 +201,8 @@ namespace infini
         inline TensorVec getOutputs() const
         {
             TensorVec ret;
-            for (const auto &t : tensors)
-                if (t->getTargets().empty())
+            for (const auto &t : getTensors())
+                if (t->getTargetList().empty())
                     ret.emplace_back(t);
             return ret;
         }
@@ -112,10 +215,70 @@ namespace infini
          */
         void addOperatorAndConnect(const Operator &op);
 
+        /**
+         * @brief Removes `op` like eraseOperator but leaves the null slots
+         * for compact, so that erasing many operators stays linear.
+         */
+        void eraseOperatorInPlace(const Operator &op);
+        /**
+         * @brief Marks the outputs of operators whose inputs are all
+         * constant as constant, in topological order, so that tensors marked
+         * after their readers were added still reach their dependents.
+         */
+        void propagateConstants();
+        void dropOperator(const Operator &op);
+        void dropTensor(const Tensor &tensor);
+        /**
+         * @brief Drops the null slots left by removals and refreshes the
+         * positions in the indices.
+         */
+        void compact();
+        /**
+         * @brief Rebuilds all indices after `tensors` or `ops` were replaced
+         * wholesale.
+         */
+        void reindex();
+        /**
+         * @brief Restores the topological order after an edge `from` -> `to`
+         * appeared (Pearce-Kelly): only the operators placed between the two
+         * are visited and permuted. Returns false and clears `sorted` if the
+         * edge closed a cycle.
+         */
+        bool reorderForEdge(const OperatorObj *from, const OperatorObj *to);
+
         /**
          * @brief If the nodes is sorted in topological order.
          */
         bool sorted;
+
+        // Memory of the tensors that are neither constants nor views for one
+        // combination of input shapes (see dataMalloc).
+        struct MemoryPlan
+        {
+            std::unique_ptr<Allocator> io;
+            vector<std::pair<Tensor, Blob>> blobs;
+            // Intermediates by offset in the arena.
+            vector<std::pair<Tensor, size_t>> offsets;
+            size_t arenaBytes = 0;
+        };
+        /**
+         * @brief Places the intermediates of `plan`, whose graph inputs and
+         * outputs are bound already, in topological order.
+         */
+        void planActivations(MemoryPlan &plan);
+        void bindPlan(MemoryPlan &plan);
+
+        // Shared with the graphs cloneWithSharedWeights makes.
+        std::shared_ptr<Allocator> weights;
+        Arena arena;
+        std::map<vector<Shape>, MemoryPlan> plans;
+        MemoryPlan *boundPlan = nullptr;
+        size_t boundGeneration = 0;
+
+        // Positions in `tensors`/`ops` by guid, and tensors by fuid.
+        std::unordered_map<UidBaseType, size_t> tensorIndex, opIndex;
+        std::unordered_map<UidBaseType, Tensor> tensorByFuid;
+        size_t removedTensors = 0, removedOps = 0;
     };
 
 } // namespace infini
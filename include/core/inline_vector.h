@@ -0,0 +1,174 @@
+#pragma once
+#include "core/common.h"
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+namespace infini
+{
+    /**
+     * @brief A vector with a fixed capacity stored inline, for small metadata
+     * such as shapes and strides. Copying or building one never touches the
+     * heap; growing past the capacity is an error.
+     */
+    template <typename T, size_t N>
+    class InlineVector
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "InlineVector holds plain values");
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T &;
+        using const_reference = const T &;
+        using pointer = T *;
+        using const_pointer = const T *;
+        using iterator = T *;
+        using const_iterator = const T *;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        InlineVector() = default;
+        explicit InlineVector(size_t n, const T &value = T()) { resize(n, value); }
+        InlineVector(std::initializer_list<T> init)
+            : InlineVector(init.begin(), init.end()) {}
+        template <typename It,
+                  typename = std::enable_if_t<!std::is_integral_v<It>>>
+        InlineVector(It first, It last)
+        {
+            for (; first != last; ++first)
+                push_back(*first);
+        }
+        InlineVector(const std::vector<T> &vec)
+            : InlineVector(vec.begin(), vec.end()) {}
+
+        operator std::vector<T>() const { return {begin(), end()}; }
+
+        static constexpr size_t capacity() { return N; }
+        size_t size() const { return len; }
+        bool empty() const { return len == 0; }
+
+        T *data() { return elems; }
+        const T *data() const { return elems; }
+        T &operator[](size_t i) { return elems[i]; }
+        const T &operator[](size_t i) const { return elems[i]; }
+        T &at(size_t i)
+        {
+            IT_ASSERT(i < len, "Index exceeded");
+            return elems[i];
+        }
+        const T &at(size_t i) const
+        {
+            IT_ASSERT(i < len, "Index exceeded");
+            return elems[i];
+        }
+        T &front() { return elems[0]; }
+        const T &front() const { return elems[0]; }
+        T &back() { return elems[len - 1]; }
+        const T &back() const { return elems[len - 1]; }
+
+        iterator begin() { return elems; }
+        iterator end() { return elems + len; }
+        const_iterator begin() const { return elems; }
+        const_iterator end() const { return elems + len; }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+        const_reverse_iterator rbegin() const
+        {
+            return const_reverse_iterator(end());
+        }
+        const_reverse_iterator rend() const
+        {
+            return const_reverse_iterator(begin());
+        }
+
+        void push_back(const T &value)
+        {
+            IT_ASSERT(len < N, "InlineVector capacity " + std::to_string(N) +
+                                   " exceeded");
+            elems[len++] = value;
+        }
+        T &emplace_back(const T &value)
+        {
+            push_back(value);
+            return back();
+        }
+        void pop_back() { --len; }
+        void clear() { len = 0; }
+        void resize(size_t n, const T &value = T())
+        {
+            IT_ASSERT(n <= N, "InlineVector capacity " + std::to_string(N) +
+                                  " exceeded");
+            for (size_t i = len; i < n; ++i)
+                elems[i] = value;
+            len = n;
+        }
+
+        iterator insert(const_iterator pos, const T &value)
+        {
+            // `value` may be an element that the shift below overwrites.
+            T copy = value;
+            return insert(pos, &copy, &copy + 1);
+        }
+        template <typename It,
+                  typename = std::enable_if_t<!std::is_integral_v<It>>>
+        iterator insert(const_iterator pos, It first, It last)
+        {
+            size_t at = pos - begin();
+            size_t n = std::distance(first, last);
+            IT_ASSERT(len + n <= N, "InlineVector capacity " +
+                                        std::to_string(N) + " exceeded");
+            // The range may lie in this vector, where the shift moves it.
+            T staged[N];
+            std::copy(first, last, staged);
+            std::move_backward(elems + at, elems + len, elems + len + n);
+            std::copy(staged, staged + n, elems + at);
+            len += n;
+            return elems + at;
+        }
+        iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            size_t at = first - begin(), n = last - first;
+            std::copy(elems + at + n, elems + len, elems + at);
+            len -= n;
+            return elems + at;
+        }
+
+        friend bool operator==(const InlineVector &a, const InlineVector &b)
+        {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end());
+        }
+        friend bool operator!=(const InlineVector &a, const InlineVector &b)
+        {
+            return !(a == b);
+        }
+        friend bool operator<(const InlineVector &a, const InlineVector &b)
+        {
+            return std::lexicographical_compare(a.begin(), a.end(), b.begin(),
+                                                b.end());
+        }
+
+    private:
+        T elems[N] = {};
+        uint32_t len = 0;
+    };
+
+    template <typename T, size_t N>
+    std::string vecToString(const InlineVector<T, N> &vec)
+    {
+        return vecToString(vec.data(), vec.size());
+    }
+
+    template <typename T, size_t N>
+    std::ostream &operator<<(std::ostream &os, const InlineVector<T, N> &vec)
+    {
+        return os << vecToString(vec);
+    }
+
+} // namespace infini
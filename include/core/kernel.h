@@ -1,6 +1,7 @@
 #pragma once
 #include "core/common.h"
 #include "core/operator.h"
+#include "core/runtime.h"
 #include "core/tensor.h"
 #include "utils/operator_utils.h"
 #include <functional>
@@ -21,6 +22,17 @@ namespace infini
          */
         virtual void compute(const Operator &op,
                              const RuntimeObj *context) const = 0;
+
+        /**
+         * @brief Rewrites constant inputs of `op` once, before it first runs,
+         * in the layout compute reads fastest, and records the layout on
+         * `op`. Returns true if anything was rewritten.
+         */
+        virtual bool packConstants(const Operator &op,
+                                   const RuntimeObj *context) const
+        {
+            return false;
+        }
     };
 
     class KernelRegistry
@@ -70,6 +82,19 @@ namespace infini
     public:
         virtual void compute(const Operator &op,
                              const RuntimeObj *context) const = 0;
+
+    protected:
+        // Minimum iterations handed to a thread by per-element loops.
+        static constexpr size_t kElementGrain = 1024;
+
+        /**
+         * @brief Intra-op thread pool of the CPU runtime running the kernel.
+         */
+        static ThreadPool &getThreadPool(const RuntimeObj *context)
+        {
+            return static_cast<const NativeCpuRuntimeObj *>(context)
+                ->getThreadPool();
+        }
     };
 
 } // namespace infini
@@ -1,6 +1,7 @@
 #pragma once
 #include "core/common.h"
 #include "ref.h"
+#include <atomic>
 
 namespace infini {
 
@@ -19,9 +20,11 @@ class Uid {
 
 class Guid : public Uid {
   private:
+    // Atomic so that graphs can be built on several threads at once. Ids
+    // only need to be unique, so no ordering is implied.
     UidBaseType generateGuid() {
-        static UidBaseType guidCnt = 0;
-        return ++guidCnt;
+        static std::atomic<UidBaseType> guidCnt{0};
+        return guidCnt.fetch_add(1, std::memory_order_relaxed) + 1;
     }
 
   public:
@@ -35,8 +38,8 @@ class Guid : public Uid {
 class Fuid : public Uid {
   private:
     UidBaseType generateFuid() {
-        static UidBaseType fuidCnt = 0;
-        return ++fuidCnt;
+        static std::atomic<UidBaseType> fuidCnt{0};
+        return fuidCnt.fetch_add(1, std::memory_order_relaxed) + 1;
     }
 
   public:
@@ -7,6 +7,15 @@ namespace infini
 {
     using KernelAttrs = std::tuple<Device, OpType::underlying_t>;
 
+    /**
+     * @brief Analytic cost of running an operator once, derived from shapes.
+     */
+    struct OpCost
+    {
+        size_t flops = 0; // Arithmetic operations.
+        size_t bytes = 0; // Bytes read from inputs and written to outputs.
+    };
+
     class GraphObj;
     class OperatorObj : public Object
     {
@@ -16,8 +25,8 @@ namespace infini
         OpType type;
         TensorVec inputs;
         TensorVec outputs;
-        vector<WRef<OperatorObj>> predecessors;
-        vector<WRef<OperatorObj>> successors;
+        OpRefList predecessors;
+        OpRefList successors;
 
     public:
         OperatorObj(OpType opType, TensorVec inputs, TensorVec outputs);
@@ -31,6 +40,25 @@ namespace infini
          * function.
          */
         bool checkValid(GraphObj *graph);
+        /**
+         * @brief Estimated work of this operator. The default counts one
+         * operation per output element (element-wise, unary and cast ops) and
+         * every input and output byte once, i.e. the minimum traffic with
+         * broadcast operands read a single time.
+         */
+        virtual OpCost getCost() const;
+        /**
+         * @brief The type followed by the attributes that, with the inputs,
+         * determine the outputs, e.g. a Transpose permutation. Operators with
+         * equal vectors and inputs compute the same values.
+         */
+        virtual vector<int> getOpAttrVector() const;
+        /**
+         * @brief For an operator whose output is a window of input 0's
+         * memory, the element offset of the output in it. Such outputs share
+         * the input's buffer (see GraphObj::dataMalloc).
+         */
+        virtual optional<size_t> getAliasOffset() const { return std::nullopt; }
 
     public: // getter and setter
         const TensorVec &getInputs() const { return inputs; }
@@ -46,8 +74,13 @@ namespace infini
             IT_ASSERT(i < outputs.size(), "Index exceeded");
             return outputs.at(i);
         }
-        OpVec getPredecessors() const { return wrefs_to_refs(predecessors); }
-        OpVec getSuccessors() const { return wrefs_to_refs(successors); }
+        OpVec getPredecessors() const { return predecessors.lock(); }
+        OpVec getSuccessors() const { return successors.lock(); }
+        /**
+         * @brief Non-owning views of the links for graph traversals.
+         */
+        const OpRefList &getPredecessorList() const { return predecessors; }
+        const OpRefList &getSuccessorList() const { return successors; }
         OpType getOpType() const { return type; }
         // HACK: set correct data type
         DataType getDType() const { return getInputs(0)->getDType(); }
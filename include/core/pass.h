@@ -0,0 +1,307 @@
+#pragma once
+#include "core/graph.h"
+#include <functional>
+
+namespace infini
+{
+    class PatternRewriter;
+
+    /**
+     * @brief A local rewrite rooted at one operator, e.g. folding a Transpose
+     * into the MatMul consuming it.
+     */
+    class RewritePattern
+    {
+    public:
+        /**
+         * @param rootTypes Operator types the pattern may be rooted at; empty
+         * means any.
+         * @param benefit Patterns with a higher benefit are tried first.
+         */
+        RewritePattern(string name, vector<OpType> rootTypes, int benefit = 1)
+            : name(std::move(name)), rootTypes(std::move(rootTypes)),
+              benefit(benefit) {}
+        virtual ~RewritePattern() {}
+
+        const string &getName() const { return name; }
+        const vector<OpType> &getRootTypes() const { return rootTypes; }
+        int getBenefit() const { return benefit; }
+
+        /**
+         * @brief Rewrites the graph around `op` if the pattern matches.
+         * All edits must go through `rewriter`. Returns true if the graph
+         * changed.
+         */
+        virtual bool matchAndRewrite(const Operator &op,
+                                     PatternRewriter &rewriter) const = 0;
+
+    private:
+        string name;
+        vector<OpType> rootTypes;
+        int benefit;
+    };
+
+    /**
+     * @brief True if `op` is the only reader of `tensor`. A graph output has
+     * no readers.
+     */
+    inline bool onlyUsedBy(const Tensor &tensor, const OperatorObj *op)
+    {
+        for (auto *target : tensor->getTargetList())
+            if (target != op)
+                return false;
+        return true;
+    }
+
+    /**
+     * @brief Graph edits available to patterns. Every operator an edit may
+     * enable a new match on is handed to the driver's worklist.
+     */
+    class PatternRewriter
+    {
+    public:
+        PatternRewriter(GraphObj &graph,
+                        std::function<void(const Operator &)> notify)
+            : graph(graph), notify(std::move(notify)) {}
+
+        GraphObj &getGraph() const { return graph; }
+
+        template <typename T, typename... Args>
+        Ref<T> addOp(Args &&...args)
+        {
+            auto op = graph.addOp<T>(std::forward<Args>(args)...);
+            notify(op);
+            return op;
+        }
+        Operator cloneOp(const Operator &op, const TensorVec &inputs)
+        {
+            auto ret = graph.cloneOperator(op, inputs);
+            notify(ret);
+            return ret;
+        }
+        /**
+         * @brief Replaces `op` by a new T built from `args`, which name
+         * `op`'s outputs as the outputs (see GraphObj::addOpWithOutputs).
+         * Unlike rewiring consumers, this works for graph outputs.
+         */
+        template <typename T, typename... Args>
+        Ref<T> replaceOpWithNew(const Operator &op, Args &&...args)
+        {
+            Ref<T> ret =
+                infini::make_ref<T>(nullptr, std::forward<Args>(args)...);
+            TensorVec inputs = op->getInputs();
+            graph.replaceOperator(op, ret);
+            notify(ret);
+            notifyProducers(inputs);
+            return ret;
+        }
+        void replaceInput(const Operator &op, const Tensor &oldInput,
+                          const Tensor &newInput);
+        void replaceAllUses(const Tensor &from, const Tensor &to);
+        /**
+         * @brief Moves the readers of `op`'s output to `value`, which must
+         * have the same shape and type, and erases `op`. Returns false and
+         * leaves `op` if its output is a graph output, which has no readers.
+         */
+        bool replaceOpWithValue(const Operator &op, const Tensor &value);
+        /**
+         * @brief Erases `op`, whose outputs must be unused, and the producers
+         * left without consumers by its removal.
+         */
+        void eraseOp(const Operator &op);
+        /**
+         * @brief Reports an in-place change of `op`'s attributes.
+         */
+        void modified(const Operator &op) { notify(op); }
+
+    private:
+        // Producers that lost a consumer may match now.
+        void notifyProducers(const TensorVec &tensors);
+
+        GraphObj &graph;
+        std::function<void(const Operator &)> notify;
+    };
+
+    /**
+     * @brief What a pass did over all the times it ran.
+     */
+    struct PassStatistics
+    {
+        string name;
+        size_t runs = 0;
+        size_t changes = 0; // Runs that changed the graph.
+        double totalMs = 0;
+        std::map<string, size_t> counters; // E.g. applications per pattern.
+    };
+
+    class Pass
+    {
+    public:
+        explicit Pass(string name) : name(std::move(name)) {}
+        virtual ~Pass() {}
+        const string &getName() const { return name; }
+        /**
+         * @brief Transforms `graph`; returns true if it changed.
+         */
+        virtual bool run(GraphObj &graph, PassStatistics &stats) = 0;
+
+    private:
+        string name;
+    };
+
+    /**
+     * @brief Applies patterns greedily until none matches. Operators are
+     * visited in topological order from a worklist; an applied rewrite
+     * re-queues only the operators it touched.
+     */
+    class PatternRewritePass : public Pass
+    {
+    public:
+        PatternRewritePass(string name,
+                           vector<std::shared_ptr<RewritePattern>> patterns);
+        bool run(GraphObj &graph, PassStatistics &stats) override;
+
+    private:
+        // Per root type, sorted by decreasing benefit; generic patterns are
+        // merged into every list.
+        std::map<OpType::underlying_t,
+                 vector<std::shared_ptr<RewritePattern>>>
+            byRoot;
+        vector<std::shared_ptr<RewritePattern>> generic;
+    };
+
+    /**
+     * @brief Common subexpression elimination. Of the operators with equal
+     * attribute vectors (OperatorObj::getOpAttrVector) and inputs, found by
+     * hashing, one is kept and the readers of the others are moved to its
+     * outputs. A duplicate is kept if both write graph outputs.
+     */
+    class CommonSubexpressionElimination : public Pass
+    {
+    public:
+        CommonSubexpressionElimination() : Pass("CSE") {}
+        bool run(GraphObj &graph, PassStatistics &stats) override;
+    };
+
+    /**
+     * @brief Runs a pipeline of passes until none changes the graph.
+     */
+    class PassManager
+    {
+    public:
+        void addPass(std::unique_ptr<Pass> pass);
+        template <typename T, typename... Args>
+        T &addPass(Args &&...args)
+        {
+            auto pass = std::make_unique<T>(std::forward<Args>(args)...);
+            T &ret = *pass;
+            addPass(std::move(pass));
+            return ret;
+        }
+        /**
+         * @brief Upper bound of pipeline repetitions.
+         */
+        void setMaxIterations(int n) { maxIterations = n; }
+        /**
+         * @brief Checks the graph after every pass that changed it.
+         */
+        void setVerify(bool enable) { verify = enable; }
+
+        /**
+         * @brief Returns true if any pass changed the graph.
+         */
+        bool run(GraphObj &graph);
+
+        const vector<PassStatistics> &getStatistics() const { return stats; }
+        /**
+         * @brief Table of runs, changes and time per pass with the pass
+         * counters below each row.
+         */
+        string statistics() const;
+
+        /**
+         * @brief The default optimisation pipeline: CSE, then all registered
+         * patterns.
+         */
+        static PassManager createDefault();
+        /**
+         * @brief The patterns registered to run once constants hold their
+         * data (see GraphObj::foldConstants).
+         */
+        static PassManager createLoadTime();
+
+    private:
+        vector<std::unique_ptr<Pass>> passes;
+        vector<PassStatistics> stats;
+        int maxIterations = 8;
+        bool verify = false;
+    };
+
+    class PatternRegistry
+    {
+    public:
+        static PatternRegistry &getInstance()
+        {
+            static PatternRegistry instance;
+            return instance;
+        }
+        bool registerPattern(std::shared_ptr<RewritePattern> pattern)
+        {
+            for (auto &p : patterns)
+                IT_ASSERT(p->getName() != pattern->getName(),
+                          "Pattern " + pattern->getName() +
+                              " already registered");
+            patterns.emplace_back(std::move(pattern));
+            return true;
+        }
+        const vector<std::shared_ptr<RewritePattern>> &getPatterns() const
+        {
+            return patterns;
+        }
+
+        /**
+         * @brief Registers a pattern that reads the data of constants. Such
+         * patterns run after dataMalloc, so they may only rewire and erase:
+         * a tensor they created would have no buffer.
+         */
+        bool registerLoadPattern(std::shared_ptr<RewritePattern> pattern)
+        {
+            for (auto &p : loadPatterns)
+                IT_ASSERT(p->getName() != pattern->getName(),
+                          "Pattern " + pattern->getName() +
+                              " already registered");
+            loadPatterns.emplace_back(std::move(pattern));
+            return true;
+        }
+        const vector<std::shared_ptr<RewritePattern>> &
+        getLoadPatterns() const
+        {
+            return loadPatterns;
+        }
+
+    private:
+        vector<std::shared_ptr<RewritePattern>> patterns, loadPatterns;
+    };
+
+} // namespace infini
+
+#define _REGISTER_PATTERN_1(pattern, cnt)                                   \
+    namespace infini                                                        \
+    {                                                                       \
+        static const bool _CAT(_register_pattern_, cnt) =                   \
+            PatternRegistry::getInstance().registerPattern(                 \
+                std::make_shared<pattern>());                               \
+    }
+
+#define REGISTER_PATTERN(pattern) _REGISTER_PATTERN_1(pattern, __COUNTER__)
+
+#define _REGISTER_LOAD_PATTERN_1(pattern, cnt)                              \
+    namespace infini                                                        \
+    {                                                                       \
+        static const bool _CAT(_register_load_pattern_, cnt) =              \
+            PatternRegistry::getInstance().registerLoadPattern(             \
+                std::make_shared<pattern>());                               \
+    }
+
+#define REGISTER_LOAD_PATTERN(pattern)                                      \
+    _REGISTER_LOAD_PATTERN_1(pattern, __COUNTER__)
@@ -0,0 +1,76 @@
+#pragma once
+#include "core/common.h"
+#include <cstdint>
+
+namespace infini
+{
+    /**
+     * @brief Hardware event counts, summed over the counted threads.
+     */
+    struct CounterValues
+    {
+        uint64_t cycles = 0;
+        uint64_t instructions = 0;
+        uint64_t llcMisses = 0;
+
+        // Saturates at zero: multiplexed counts are scaled estimates and two
+        // reads can come out slightly non-monotonic.
+        CounterValues operator-(const CounterValues &rhs) const
+        {
+            auto sub = [](uint64_t a, uint64_t b)
+            { return a > b ? a - b : 0; };
+            return {sub(cycles, rhs.cycles),
+                    sub(instructions, rhs.instructions),
+                    sub(llcMisses, rhs.llcMisses)};
+        }
+        CounterValues &operator+=(const CounterValues &rhs)
+        {
+            cycles += rhs.cycles;
+            instructions += rhs.instructions;
+            llcMisses += rhs.llcMisses;
+            return *this;
+        }
+        double ipc() const
+        {
+            return cycles ? double(instructions) / cycles : 0.;
+        }
+        /**
+         * @brief DRAM traffic implied by the LLC misses. Uncore memory
+         * controller counters are not portable, so one cache line per miss is
+         * the bandwidth estimate we can get everywhere.
+         */
+        uint64_t estimatedDramBytes() const;
+    };
+
+    /**
+     * @brief Per-thread perf_event_open counter groups (cycles, instructions,
+     * LLC misses). Construction never throws: when the kernel, the PMU or
+     * perf_event_paranoid refuse the events, isAvailable() is false and
+     * getError() tells why.
+     */
+    class PerfCounters
+    {
+    public:
+        /**
+         * @brief Counts the given Linux thread ids; 0 means the calling thread.
+         */
+        explicit PerfCounters(const vector<int> &tids = {0});
+        PerfCounters(const PerfCounters &) = delete;
+        PerfCounters &operator=(const PerfCounters &) = delete;
+        ~PerfCounters();
+
+        bool isAvailable() const { return available; }
+        const string &getError() const { return error; }
+        /**
+         * @brief Current totals, scaled up if the kernel had to multiplex the
+         * groups. Returns zeros when counters are unavailable.
+         */
+        CounterValues read() const;
+
+    private:
+        bool available = false;
+        string error;
+        vector<vector<int>> groups; // fds of one thread, leader first.
+    };
+
+} // namespace infini
@@ -0,0 +1,91 @@
+#pragma once
+#include "core/data_type.h"
+#include "core/object.h"
+#include "core/op_type.h"
+#include "core/operator.h"
+#include "core/perf_counters.h"
+#include "core/roofline.h"
+#include <chrono>
+#include <mutex>
+
+namespace infini
+{
+    /**
+     * @brief One kernel execution captured by the profiler.
+     */
+    struct ProfileRecord
+    {
+        UidBaseType opGuid;
+        OpType opType;
+        string kernelName;
+        vector<Shape> inputShapes;
+        DataType dtype;
+        int threadId;   // Small integer id of the thread that ran the op.
+        int numThreads; // Threads the runtime allowed the kernel to use.
+        double startUs; // Relative to the profiler's epoch.
+        double durationUs;
+        OpCost cost;
+        // Hardware counter deltas over the kernel call, summed over the
+        // calling thread and the pool workers.
+        bool hasCounters = false;
+        CounterValues counters;
+    };
+
+    /**
+     * @brief Collects per-operator timings of NativeCpuRuntimeObj::run. Records
+     * may come from several threads at once.
+     */
+    class Profiler
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        Profiler() : epoch(Clock::now()) {}
+
+        void record(ProfileRecord record);
+        /**
+         * @brief Drops all records and restarts the timeline at zero.
+         */
+        void clear();
+        vector<ProfileRecord> getRecords() const;
+        double toUs(Clock::time_point t) const;
+
+        /**
+         * @brief Why hardware counters were requested but not recorded.
+         */
+        void setCounterError(const string &error);
+
+        /**
+         * @brief Table of calls, total/average time and share of the total,
+         * aggregated by operator type and sorted by total time. IPC, LLC
+         * misses per KB moved and the estimated DRAM bandwidth are added when
+         * hardware counters were recorded.
+         */
+        string summary() const;
+        void printSummary() const;
+        /**
+         * @brief The records as a chrome://tracing / Perfetto JSON timeline.
+         */
+        string toChromeTrace() const;
+        void dumpChromeTrace(const string &path) const;
+        /**
+         * @brief Per operator achieved GFLOP/s and GB/s from the analytic
+         * cost and the measured time, and the fraction of the roofline bound
+         * min(peak, intensity * bandwidth) reached. Sorted by total time, so
+         * the first rows are the kernels worth optimising first.
+         */
+        string rooflineReport(const Roofline &machine) const;
+
+        /**
+         * @brief Stable small id of the calling thread, used as trace tid.
+         */
+        static int currentThreadId();
+
+    private:
+        mutable std::mutex mtx;
+        Clock::time_point epoch;
+        vector<ProfileRecord> records;
+        string counterError;
+    };
+
+} // namespace infini
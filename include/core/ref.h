@@ -1,6 +1,8 @@
 #pragma once
 #include "core/common.h"
+#include <algorithm>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <type_traits>
 
@@ -40,4 +42,82 @@ std::vector<Ref<T>> wrefs_to_refs(const std::vector<WRef<T>> &wrefs) {
     return refs;
 }
 
+/**
+ * @brief Weak references that can be traversed without locking them.
+ *
+ * Each entry keeps the raw pointer next to its weak reference. Iteration
+ * yields the raw pointers of the entries that have not expired, so graph
+ * traversals neither allocate nor touch reference counts. The pointers are
+ * only valid while their owner (e.g. the graph) keeps the objects alive.
+ */
+template <typename T> class WRefList {
+    using Entry = std::pair<WRef<T>, T *>;
+    std::vector<Entry> entries;
+
+  public:
+    class Iterator {
+        typename std::vector<Entry>::const_iterator it, end;
+        void skipExpired() {
+            while (it != end && it->first.expired())
+                ++it;
+        }
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T *;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T *const *;
+        using reference = T *;
+
+        Iterator(typename std::vector<Entry>::const_iterator it,
+                 typename std::vector<Entry>::const_iterator end)
+            : it(it), end(end) {
+            skipExpired();
+        }
+        T *operator*() const { return it->second; }
+        Iterator &operator++() {
+            ++it;
+            skipExpired();
+            return *this;
+        }
+        bool operator==(const Iterator &rhs) const { return it == rhs.it; }
+        bool operator!=(const Iterator &rhs) const { return it != rhs.it; }
+    };
+
+    Iterator begin() const { return {entries.begin(), entries.end()}; }
+    Iterator end() const { return {entries.end(), entries.end()}; }
+    bool empty() const { return begin() == end(); }
+    size_t size() const { return std::distance(begin(), end()); }
+
+    void emplace_back(const Ref<T> &ref) { entries.emplace_back(ref, ref.get()); }
+    /**
+     * @brief Removes every entry pointing to `ptr`.
+     */
+    void remove(const T *ptr) {
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [ptr](const Entry &e) {
+                                         return e.second == ptr;
+                                     }),
+                      entries.end());
+    }
+    void removeExpired() {
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [](const Entry &e) {
+                                         return e.first.expired();
+                                     }),
+                      entries.end());
+    }
+    void clear() { entries.clear(); }
+    /**
+     * @brief Strong references to the live entries.
+     */
+    std::vector<Ref<T>> lock() const {
+        std::vector<Ref<T>> refs;
+        for (const auto &e : entries)
+            if (auto ref = e.first.lock())
+                refs.emplace_back(std::move(ref));
+        return refs;
+    }
+};
+
 } // namespace infini
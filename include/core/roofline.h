@@ -0,0 +1,32 @@
+#pragma once
+#include "core/thread_pool.h"
+
+namespace infini
+{
+    /**
+     * @brief Machine ceilings of the roofline model.
+     */
+    struct Roofline
+    {
+        double peakGflops = 0;   // Attainable FP32 arithmetic throughput.
+        double bandwidthGBs = 0; // Sustained memory bandwidth.
+
+        /**
+         * @brief Attainable GFLOP/s at the given FLOPs per byte.
+         */
+        double attainableGflops(double intensity) const
+        {
+            return std::min(peakGflops, intensity * bandwidthGBs);
+        }
+    };
+
+    /**
+     * @brief Measures the ceilings with all threads of the pool: a STREAM
+     * triad over three arrays of `bytesPerArray` bytes for bandwidth, and
+     * independent multiply-add chains for arithmetic. The arrays should be
+     * several times the last-level cache for the bandwidth to be DRAM's.
+     */
+    Roofline probeRoofline(ThreadPool &pool,
+                           size_t bytesPerArray = size_t(64) << 20);
+
+} // namespace infini
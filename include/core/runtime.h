@@ -2,6 +2,9 @@
 #include "core/common.h"
 #include "core/op_type.h"
 #include "core/ref.h"
+#include "core/roofline.h"
+#include "core/thread_pool.h"
+#include <mutex>
 
 namespace infini
 {
@@ -19,6 +22,7 @@ namespace infini
 
   using TensorVec = vector<Tensor>;
   using OpVec = vector<Operator>;
+  using OpRefList = WRefList<OperatorObj>;
 
   enum class Device
   {
@@ -46,13 +50,26 @@ namespace infini
       return true;
     }
 
+    Device getDevice() const { return device; }
+
     virtual string toString() const = 0;
   };
 
+  class Profiler;
+
   class NativeCpuRuntimeObj : public RuntimeObj
   {
+    std::unique_ptr<ThreadPool> threadPool;
+    std::unique_ptr<Profiler> profiler;
+    bool profiling = false;
+    bool hardwareCounters = false;
+    mutable std::once_flag rooflineProbed;
+    mutable Roofline roofline;
+
   public:
-    NativeCpuRuntimeObj() : RuntimeObj(Device::CPU) {}
+    explicit NativeCpuRuntimeObj(
+        const ThreadPoolConfig &config = ThreadPoolConfig::fromEnv());
+    ~NativeCpuRuntimeObj() override;
 
     static Ref<NativeCpuRuntimeObj> &getInstance()
     {
@@ -64,6 +81,51 @@ namespace infini
     void run(const Graph &graph) const override;
     void *alloc(size_t size) override;
     string toString() const override;
+
+    ThreadPool &getThreadPool() const { return *threadPool; }
+    /**
+     * @brief Threads worth spending on an operator according to its
+     * estimated cost. Returns 1 when the operator should run inline.
+     */
+    int getNumThreadsFor(const Operator &op) const;
+
+    /**
+     * @brief Records per-operator timings in the profiler while enabled. When
+     * disabled run() pays a single branch per graph.
+     */
+    void setProfiling(bool enable) { profiling = enable; }
+    bool isProfiling() const { return profiling; }
+    /**
+     * @brief Additionally wraps every kernel call of a profiled run with
+     * perf_event_open counters on the calling thread and the pool workers.
+     * Runs without counters (and says why in the summary) when the system
+     * refuses them. Counts are only attributable while one graph runs at a
+     * time on this runtime.
+     */
+    void setHardwareCounters(bool enable) { hardwareCounters = enable; }
+    bool isHardwareCounters() const { return hardwareCounters; }
+    /**
+     * @brief Machine ceilings, probed with the thread pool on first use.
+     */
+    const Roofline &getRoofline() const;
+    /**
+     * @brief Prints the profiler's records against the machine roofline.
+     */
+    void printRooflineReport() const;
+    Profiler &getProfiler() const { return *profiler; }
+
+    /**
+     * @brief Replaces the intra-op thread pool. Must not be called while a
+     * graph is running on this runtime.
+     */
+    void setThreadPoolConfig(const ThreadPoolConfig &config)
+    {
+      threadPool.reset();
+      threadPool.reset(new ThreadPool(config));
+    }
+
+  private:
+    void runWithProfiler(const Graph &graph) const;
   };
 
 } // namespace infini
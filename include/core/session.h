@@ -0,0 +1,39 @@
+#pragma once
+#include "core/graph.h"
+
+namespace infini
+{
+    /**
+     * @brief Runs a shared model: a copy of the model's graph whose
+     * constants, e.g. weights, stay in the model's buffers, with inputs,
+     * outputs and an activation arena of its own. Sessions of one model may
+     * be created and run on different threads at the same time; each session
+     * is used by one thread at a time.
+     */
+    class SessionObj
+    {
+    public:
+        /**
+         * @param model A graph after dataMalloc whose constants are loaded,
+         * folded and packed. It must not change while sessions exist.
+         */
+        explicit SessionObj(const Graph &model);
+
+        /**
+         * @brief The inputs to fill before each run, in the model's order.
+         */
+        TensorVec getInputs() const;
+        TensorVec getOutputs() const { return graph->getOutputs(); }
+        /**
+         * @brief See GraphObj::resize; only this session is affected.
+         */
+        void resize(const TensorVec &inputs, const vector<Shape> &dims);
+        void run();
+        const Graph &getGraph() const { return graph; }
+
+    private:
+        Graph graph;
+    };
+
+    using Session = Ref<SessionObj>;
+} // namespace infini
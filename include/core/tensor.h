@@ -1,6 +1,7 @@
 #pragma once
 #include "core/blob.h"
 #include "core/data_type.h"
+#include "core/inline_vector.h"
 #include "core/object.h"
 #include "core/runtime.h"
 #include <cmath>
@@ -11,7 +12,13 @@ namespace infini
 {
     class GraphObj;
     using ShapeElem = int;
-    using Shape = vector<ShapeElem>;
+    // Highest tensor rank supported; shapes and index math stay off the heap.
+    constexpr size_t kMaxRank = 8;
+    using Shape = InlineVector<ShapeElem, kMaxRank>;
+    // Element strides. Sizes, offsets and strides are 64-bit, so a tensor
+    // may exceed 2^31 elements as long as each dimension fits a ShapeElem.
+    using Stride = InlineVector<size_t, kMaxRank>;
+    static_assert(sizeof(Shape) <= 64, "Shape should fit in a cache line");
     class TensorObj : public Object
     {
         friend class GraphObj;
@@ -20,10 +27,12 @@ namespace infini
         int dim;
 
         DataType dtype;
-        vector<WRef<OperatorObj>> targets;
+        OpRefList targets;
         WRef<OperatorObj> source;
+        OperatorObj *sourcePtr = nullptr; // Unlocked copy of `source`.
         Blob data;
         Runtime runtime;
+        bool constant = false;
 
     private:
         Shape shape;
@@ -37,6 +46,10 @@ namespace infini
         string toString() const override;
 
         size_t size() const { return _size; }
+        /**
+         * @brief Row-major element strides of this tensor.
+         */
+        Stride getStride() const;
         size_t getBytes() const { return _size * dtype.getSize(); }
 
         Shape getDims() const { return shape; }
@@ -72,8 +85,26 @@ namespace infini
         DataType getDType() const { return dtype; }
         Runtime getRuntime() const { return runtime; }
 
-        OpVec getTargets() const { return wrefs_to_refs(targets); }
+        /**
+         * @brief Marks a tensor whose data is fixed once loaded, e.g. a
+         * weight. Operators whose inputs are all constant have constant
+         * outputs, which GraphObj::foldConstants computes once; mark
+         * constants before GraphObj::dataMalloc.
+         */
+        void setConstant(bool enable = true) { constant = enable; }
+        bool isConstant() const { return constant; }
+
+        OpVec getTargets() const { return targets.lock(); }
         Operator getSource() const { return source.lock(); }
+        /**
+         * @brief Non-owning views for graph traversals, which avoid the
+         * allocation and reference counting of getTargets/getSource.
+         */
+        const OpRefList &getTargetList() const { return targets; }
+        OperatorObj *getSourcePtr() const
+        {
+            return source.expired() ? nullptr : sourcePtr;
+        }
 
     private:
         template <class T>
@@ -83,11 +114,11 @@ namespace infini
             builder << "Tensor: " << guid << std::endl;
 
             auto numDims = shape.size();
-            auto dimSzVec = vector<int>(numDims, 1);
+            auto dimSzVec = vector<size_t>(numDims, 1);
             auto ptr = data->getPtr<T *>();
             dimSzVec[numDims - 1] = shape[numDims - 1];
 
-            for (int i = numDims - 1; i != 0; --i)
+            for (size_t i = numDims - 1; i != 0; --i)
                 dimSzVec[i - 1] = dimSzVec[i] * shape[i - 1];
 
             for (size_t i = 0, iEnd = size(); i < iEnd; ++i)
@@ -148,17 +179,12 @@ namespace infini
         }
 
         void addTarget(const Operator &op) { targets.emplace_back(op); }
-        void setSource(const Operator &op) { source = op; }
-        void removeTarget(const Operator &op)
+        void setSource(const Operator &op)
         {
-            for (auto itr = targets.begin(); itr != targets.end();)
-            {
-                if (itr->lock() == op)
-                    itr = targets.erase(itr);
-                else
-                    ++itr;
-            }
+            source = op;
+            sourcePtr = op.get();
         }
+        void removeTarget(const Operator &op) { targets.remove(op.get()); }
     };
 
 } // namespace infini
@@ -0,0 +1,162 @@
+#pragma once
+#include "core/common.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace infini
+{
+    struct ThreadPoolConfig
+    {
+        /**
+         * @brief Threads taking part in a parallel region, the submitting
+         * thread included. A value <= 0 means hardware_concurrency().
+         */
+        int numThreads = 0;
+        /**
+         * @brief CPUs the workers are pinned to. Worker i runs on
+         * cpuAffinity[i % size]. Empty means no pinning. The submitting thread
+         * keeps whatever affinity its owner gave it.
+         */
+        vector<int> cpuAffinity;
+        /**
+         * @brief Polls an idle thread makes before it blocks on a condition
+         * variable. Larger values lower wake-up latency at the cost of burning
+         * cycles that co-located processes could use; 0 sleeps immediately.
+         */
+        int spinCount = 20000;
+        /**
+         * @brief Estimated work (FLOPs + bytes moved, see OperatorObj::getCost)
+         * an operator must have per thread before the runtime hands it another
+         * thread. Operators below this run inline on the calling thread.
+         */
+        size_t minWorkPerThread = size_t(1) << 16;
+
+        /**
+         * @brief Default config overridden by INFINI_NUM_THREADS,
+         * INFINI_CPU_AFFINITY (comma separated CPU ids), INFINI_SPIN_COUNT and
+         * INFINI_MIN_WORK_PER_THREAD.
+         */
+        static ThreadPoolConfig fromEnv();
+    };
+
+    /**
+     * @brief Intra-op thread pool owned by a runtime. Kernels split their
+     * iteration space with parallel_for/parallel_reduce; the submitting thread
+     * works on the region too, so a pool of N threads has N - 1 workers.
+     *
+     * A region is only dispatched to the workers when the pool is idle. Nested
+     * regions and regions submitted while another thread owns the pool run
+     * inline on the calling thread, which keeps concurrent callers correct.
+     */
+    class ThreadPool
+    {
+    public:
+        using RangeFunc = std::function<void(size_t, size_t)>;
+
+        explicit ThreadPool(const ThreadPoolConfig &config = ThreadPoolConfig());
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+        ~ThreadPool();
+
+        int getNumThreads() const { return numThreads; }
+        const ThreadPoolConfig &getConfig() const { return config; }
+        /**
+         * @brief OS thread ids (Linux tids) of the workers, empty elsewhere.
+         */
+        const vector<int> &getThreadIds() const { return workerTids; }
+
+        /**
+         * @brief Caps the threads of regions the current thread submits while
+         * the guard is alive. A limit of 1 runs every region inline.
+         */
+        class ConcurrencyLimit
+        {
+            int saved;
+
+        public:
+            explicit ConcurrencyLimit(int maxThreads);
+            ConcurrencyLimit(const ConcurrencyLimit &) = delete;
+            ConcurrencyLimit &operator=(const ConcurrencyLimit &) = delete;
+            ~ConcurrencyLimit();
+        };
+
+        /**
+         * @brief Calls fn(b, e) on disjoint sub-ranges covering [begin, end).
+         * Every sub-range except possibly the last holds at least `grain`
+         * iterations. Exceptions thrown by fn are rethrown on the caller.
+         */
+        void parallel_for(size_t begin, size_t end, size_t grain,
+                          const RangeFunc &fn);
+
+        /**
+         * @brief Reduces [begin, end) with map(b, e) -> T per sub-range and
+         * reduce(T, T) -> T over the partial results. Partials are combined in
+         * range order, so the result does not depend on the thread count.
+         */
+        template <typename T, typename Map, typename Reduce>
+        T parallel_reduce(size_t begin, size_t end, size_t grain, T identity,
+                          Map &&map, Reduce &&reduce)
+        {
+            if (end <= begin)
+                return identity;
+            // The split only depends on the range, never on the thread count.
+            size_t chunk = std::max({(end - begin + kReduceParts - 1) / kReduceParts,
+                                     grain, size_t(1)});
+            size_t nChunks = (end - begin + chunk - 1) / chunk;
+            vector<T> partials(nChunks, identity);
+            parallel_for(0, nChunks, 1, [&](size_t cb, size_t ce)
+                         {
+                for (size_t c = cb; c < ce; ++c)
+                    partials[c] = map(begin + c * chunk,
+                                      std::min(end, begin + (c + 1) * chunk)); });
+            T ret = identity;
+            for (auto &p : partials)
+                ret = reduce(ret, p);
+            return ret;
+        }
+
+    private:
+        static constexpr size_t kReduceParts = 256;
+
+        ThreadPoolConfig config;
+        int numThreads;
+        vector<std::thread> workers;
+        vector<int> workerTids;
+        int tidsReported = 0;
+        std::mutex tidMutex;
+        std::condition_variable tidCv;
+
+        // Published region: the high bits count regions, the low 16 bits hold
+        // the number of threads taking part in the current one.
+        std::atomic<uint64_t> epoch{0};
+        std::atomic<bool> stop{false};
+        std::atomic<int> sleepers{0};
+        std::mutex wakeMutex;
+        std::condition_variable wakeCv;
+
+        const RangeFunc *job = nullptr;
+        size_t jobBegin = 0, jobEnd = 0, jobChunk = 0;
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<int> pending{0};
+        std::mutex doneMutex;
+        std::condition_variable doneCv;
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        // Serialises regions; holders of the pool are the only writers of the
+        // job fields above.
+        std::mutex regionMutex;
+
+        int maxThreads() const;
+        size_t chunkSize(size_t n) const;
+        void workerLoop(int index);
+        // Stops the workers and waits for them to exit.
+        void joinWorkers();
+        void runChunks();
+        void waitDone();
+    };
+
+} // namespace infini
@@ -23,6 +23,8 @@ class ConcatObj : public OperatorObj {
     OP_CLONE(ConcatObj);
 
     optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+    OpCost getCost() const override;
+    vector<int> getOpAttrVector() const override;
 
     std::string toString() const override;
     int numInputs() const override { return inputs.size(); }
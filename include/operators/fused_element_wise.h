@@ -0,0 +1,64 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+  /**
+   * @brief One operation of a fused element-wise region. Value i below the
+   * number of inputs is input i; value numInputs + k is the result of step k.
+   */
+  struct FusedStep
+  {
+    OpType type = OpType::Unknown; // Add, Sub, Mul, Div, Relu, Clip or Cast.
+    int args[2] = {-1, -1};        // The values read; unary steps use one.
+    std::optional<float> min, max; // Clip bounds.
+    // Type of the result. Only a Cast, which must be the last step, changes
+    // it.
+    DataType dtype = DataType::Float32;
+  };
+
+  /**
+   * @brief Checks that every step reads values defined before it and that
+   * only the last step is a Cast.
+   */
+  void checkFusedSteps(size_t numInputs, const vector<FusedStep> &steps);
+  /**
+   * @brief Broadcast shape of the last step's result, given the shapes of
+   * the inputs.
+   */
+  Shape inferFusedShape(vector<Shape> values, const vector<FusedStep> &steps);
+  /**
+   * @brief Appends the steps to an operator's attribute vector.
+   */
+  void appendFusedSteps(vector<int> &attrs, const vector<FusedStep> &steps);
+
+  /**
+   * @brief A DAG of element-wise operators evaluated in one pass over
+   * memory: every output element is computed from the input elements it
+   * depends on, so intermediates never reach memory. Inputs broadcast to the
+   * output shape as in ElementWiseObj.
+   */
+  class FusedElementWiseObj : public OperatorObj
+  {
+  public:
+    /**
+     * @param steps The operations in topological order; the last one
+     * produces the output.
+     */
+    FusedElementWiseObj(GraphObj *graph, TensorVec inputs, Tensor output,
+                        vector<FusedStep> steps);
+    OP_CLONE(FusedElementWiseObj);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+    vector<DataType> inferDataType(const TensorVec &inputs) const override;
+    OpCost getCost() const override;
+    vector<int> getOpAttrVector() const override;
+
+    std::string toString() const override;
+    int numInputs() const override { return inputs.size(); }
+    int numOutputs() const override { return 1; }
+    const vector<FusedStep> &getSteps() const { return steps; }
+
+  private:
+    vector<FusedStep> steps;
+  };
+} // namespace infini
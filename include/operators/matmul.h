@@ -1,5 +1,6 @@
 #pragma once
 #include "core/operator.h"
+#include "operators/fused_element_wise.h"
 
 namespace infini
 {
@@ -18,6 +19,14 @@ namespace infini
         // Auxiliary attributes which are not a part of operator attributes.
         int m, n, k;
 
+        // Element-wise steps applied to C before it is stored. Value 0 is the
+        // product and value i > 0 is input i + 1 (see FusedStep).
+        vector<FusedStep> epilogue;
+
+        // Width of the column panels B's data was packed in by the kernel
+        // (see Kernel::packConstants), 0 while B is in its own layout.
+        int packedB = 0;
+
     public:
         /**
          * @brief Matmul operator with batch broadcast and tensor transpose
@@ -37,13 +46,21 @@ namespace infini
          * the constructor, C should be an empty Ref.
          * @param transA If matrix A should be transposed when computing.
          * @param transB If matrix B should be transposed when computing.
+         * @param epilogueInputs Extra tensors read by the epilogue, e.g. a
+         * bias. They must broadcast to the shape of the product.
+         * @param epilogue Steps applied to the product before C is stored.
          */
         MatmulObj(GraphObj *graph, Tensor A, Tensor B, Tensor C,
-                  bool transA = false, bool transB = false);
+                  bool transA = false, bool transB = false,
+                  TensorVec epilogueInputs = {},
+                  vector<FusedStep> epilogue = {});
         OP_CLONE(MatmulObj);
 
         std::string toString() const override;
         optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+        vector<DataType> inferDataType(const TensorVec &inputs) const override;
+        OpCost getCost() const override;
+        vector<int> getOpAttrVector() const override;
 
         int numInputs() const override { return inputs.size(); }
         int numOutputs() const override { return 1; }
@@ -55,6 +72,9 @@ namespace infini
         int getM() const { return m; }
         int getN() const { return n; }
         int getK() const { return k; }
+        const vector<FusedStep> &getEpilogue() const { return epilogue; }
+        int getPackedB() const { return packedB; }
+        void setPackedB(int width) { packedB = width; }
     };
 
 } // namespace infini
\ No newline at end of file
@@ -22,11 +22,17 @@ namespace infini
                  vector<int> permute);
     OP_CLONE(TransposeObj);
     optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+    OpCost getCost() const override;
+    vector<int> getOpAttrVector() const override;
 
     std::string toString() const override;
     int numInputs() const override { return 1; }
     int numOutputs() const override { return 1; }
-    std::vector<int> getPermute() const { return transposePermute; }
+    const std::vector<int> &getPermute() const { return transposePermute; }
+    /**
+     * @brief Replaces the permutation; the output shape must not change.
+     */
+    void setPermute(vector<int> permute);
 
   private:
     vector<int> transposePermute;
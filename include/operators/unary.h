@@ -33,6 +33,8 @@ namespace infini
             std::optional<float> min, std::optional<float> max);
     OP_CLONE(ClipObj);
     optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+    OpCost getCost() const override;
+    vector<int> getOpAttrVector() const override;
 
     std::string toString() const override;
     std::optional<float> getMin() const { return minValue; };
@@ -80,6 +82,7 @@ namespace infini
     OP_CLONE(CastObj);
     optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
     vector<DataType> inferDataType(const TensorVec &inputs) const override;
+    vector<int> getOpAttrVector() const override;
 
     std::string toString() const override;
     CastType getType() const { return castType; }
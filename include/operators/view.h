@@ -0,0 +1,42 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+  /**
+   * @brief Reads a window of the input's memory with another shape: with n
+   * the output size, the output holds input elements [index * n,
+   * (index + 1) * n) in row-major order. The output shares the input's
+   * buffer, so the op moves no data.
+   */
+  class ViewObj : public OperatorObj
+  {
+  public:
+    /**
+     * @param shape The shape of the output. A 0 copies the input's dim at
+     * the same position counted from the last, so that e.g. [0, 0] views
+     * the matrices of a stack and follows the input when it is resized.
+     * @param index Which window of the output's size to read.
+     */
+    ViewObj(GraphObj *graph, Tensor input, Tensor output, Shape shape,
+            size_t index = 0);
+    OP_CLONE(ViewObj);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+    OpCost getCost() const override;
+    vector<int> getOpAttrVector() const override;
+    optional<size_t> getAliasOffset() const override
+    {
+      return index * outputs[0]->size();
+    }
+
+    std::string toString() const override;
+    int numInputs() const override { return 1; }
+    int numOutputs() const override { return 1; }
+    const Shape &getShape() const { return shape; }
+    size_t getIndex() const { return index; }
+
+  private:
+    Shape shape;
+    size_t index;
+  };
+} // namespace infini
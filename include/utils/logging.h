@@ -0,0 +1,33 @@
+#pragma once
+#include <sstream>
+#include <string>
+
+namespace infini {
+
+enum class LogLevel { Off = 0, Warn, Info, Debug };
+
+/**
+ * @brief Current process-wide level. Defaults to INFINI_LOG_LEVEL
+ * (off|warn|info|debug or 0-3), or warn when unset.
+ */
+LogLevel getLogLevel();
+void setLogLevel(LogLevel level);
+void logMessage(LogLevel level, const std::string &msg);
+
+inline bool shouldLog(LogLevel level) {
+    return level != LogLevel::Off && level <= getLogLevel();
+}
+
+} // namespace infini
+
+// The message is a stream expression, e.g. IT_LOG(Info, "n = " << n). It is
+// only built when the level is enabled.
+#define IT_LOG(level, msg)                                                     \
+    do {                                                                       \
+        if (::infini::shouldLog(::infini::LogLevel::level)) {                  \
+            std::ostringstream _it_log_oss;                                    \
+            _it_log_oss << msg;                                                \
+            ::infini::logMessage(::infini::LogLevel::level,                    \
+                                 _it_log_oss.str());                           \
+        }                                                                      \
+    } while (0)
@@ -17,7 +17,14 @@ int get_real_axis(const int &axis, const int &rank);
 Shape locate_index(size_t inputN, const Shape &shape);
 // Delocate the ShapeIndex from Shape with broadcast
 size_t delocate_index(const Shape &shapeIndex, const Shape &shape,
-                      const Shape &stride);
+                      const Stride &stride);
+// Round dims[axis] up to the smallest bucket holding it, so that inputs padded
+// to the result share a few cached memory plans (see GraphObj::resize). Sizes
+// above the largest bucket are kept
+Shape pad_to_bucket(Shape dims, int axis, const vector<ShapeElem> &buckets);
+// Append an optional float attribute, e.g. a Clip bound, bit for bit to an
+// attribute vector
+void append_attr(vector<int> &attrs, std::optional<float> value);
 // Convert KernelAttrs to a string representation
 std::string get_kernel_attrs_str(const KernelAttrs &kernelAttrs);
 
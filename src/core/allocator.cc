@@ -1,4 +1,6 @@
 #include "core/allocator.h"
+#include "utils/logging.h"
+#include <iterator>
 #include <utility>
 
 namespace infini {
@@ -6,6 +8,7 @@ Allocator::Allocator(Runtime runtime) : runtime(runtime)
 {
     used = 0;
     peak = 0;
+    top = 0;
     ptr = nullptr;
     alignment = sizeof(uint64_t);
     // 初始化空闲块：初始状态无空闲块（首次分配从 0 地址开始）
@@ -28,6 +31,7 @@ size_t Allocator::alloc(size_t size)
 
     // =================================== 作业实现 ===================================
     size_t allocatedAddr = 0;
+    bool found = false;
 
     // 1. 查找空闲块（首次适配：找第一个能容纳 size 的空闲块）
     auto it = freeBlocks.begin();
@@ -52,21 +56,25 @@ size_t Allocator::alloc(size_t size)
                 freeBlocks.erase(it);
             }
 
+            found = true;
             break;
         }
     }
 
     // 2. 无合适空闲块，从已用内存末尾分配
-    if (it == freeBlocks.end())
+    // Freed blocks below the top leave holes, so the end of the used memory
+    // is `top`, not `used`.
+    if (!found)
     {
-        allocatedAddr = used; // 新块起始地址 = 当前已用内存大小
+        allocatedAddr = top;
+        top += size;
     }
 
     // 3. 更新已用内存和峰值内存
     used += size;
-    if (used > peak)
+    if (top > peak)
     {
-        peak = used;
+        peak = top;
     }
 
     return allocatedAddr;
@@ -128,6 +136,13 @@ void Allocator::free(size_t addr, size_t size)
 
     // 3. 更新已用内存
     used -= size;
+    // A free block at the top shrinks it instead.
+    auto last = std::prev(freeBlocks.end());
+    if (last->first + last->second == top)
+    {
+        top = last->first;
+        freeBlocks.erase(last);
+    }
     // =================================== 作业实现 ===================================
 }
 
@@ -136,7 +151,8 @@ void *Allocator::getPtr()
     if (this->ptr == nullptr)
     {
         this->ptr = runtime->alloc(this->peak);
-        printf("Allocator really alloc: %p %lu bytes\n", this->ptr, peak);
+        IT_LOG(Debug, "Allocator really alloc: " << this->ptr << " " << peak
+                                                 << " bytes");
     }
     return this->ptr;
 }
@@ -148,8 +164,32 @@ size_t Allocator::getAlignedSize(size_t size)
 
 void Allocator::info()
 {
-    std::cout << "Used memory: " << this->used
-              << ", peak memory: " << this->peak
-              << ", free blocks count: " << freeBlocks.size() << std::endl;
+    IT_LOG(Debug, "Used memory: " << this->used
+                                  << ", peak memory: " << this->peak
+                                  << ", free blocks count: "
+                                  << freeBlocks.size());
+}
+
+void *ArenaObj::reserve(size_t bytes)
+{
+    if (bytes > size)
+    {
+        reset();
+        ptr = runtime->alloc(bytes);
+        size = bytes;
+        ++generation;
+    }
+    return ptr;
+}
+
+void ArenaObj::reset()
+{
+    if (ptr != nullptr)
+    {
+        runtime->dealloc(ptr);
+        ptr = nullptr;
+        size = 0;
+        ++generation;
+    }
 }
 }
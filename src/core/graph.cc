@@ -1,16 +1,66 @@
 #include "core/graph.h"
+#include "core/kernel.h"
+#include "core/pass.h"
 #include <algorithm>
 #include <numeric>
-#include <queue>
-#include "operators/transpose.h"
-#include "operators/matmul.h"
+#include <unordered_set>
 namespace infini
 {
 
+    Operator GraphObj::cloneOperator(const Operator &op,
+                                     const TensorVec &inputs)
+    {
+        auto shapes = op->inferShape(inputs);
+        IT_ASSERT(shapes,
+                  "Cannot clone " + op->toString() + " onto new inputs");
+        auto dtypes = op->inferDataType(inputs);
+        // Shape inference may cache attributes of the inputs it saw (e.g.
+        // MatMul's m, n, k); recompute them from op's own inputs.
+        IT_ASSERT(op->checkValid(nullptr));
+        TensorVec outputs;
+        for (size_t i = 0; i < shapes->size(); ++i)
+            outputs.emplace_back(addTensor((*shapes)[i], dtypes[i]));
+        auto ret = op->clone(inputs, outputs);
+        addOperatorAndConnect(ret);
+        return ret;
+    }
+
+    Graph GraphObj::cloneWithSharedWeights() const
+    {
+        IT_ASSERT(weights, "Weights are shared after dataMalloc");
+        IT_ASSERT(sorted);
+        auto ret = make_ref<GraphObj>(runtime);
+        ret->weights = weights;
+        std::unordered_map<const TensorObj *, Tensor> copies;
+        for (const auto &tensor : getTensors())
+        {
+            auto copy = ret->addTensor(tensor->getDims(), tensor->getDType());
+            if (tensor->isConstant())
+            {
+                copy->setConstant();
+                copy->setDataBlob(tensor->data);
+            }
+            copies.emplace(tensor.get(), copy);
+        }
+        for (const auto &op : getOperators())
+        {
+            TensorVec inputs, outputs;
+            for (const auto &input : op->getInputs())
+                inputs.emplace_back(copies.at(input.get()));
+            for (const auto &output : op->getOutputs())
+                outputs.emplace_back(copies.at(output.get()));
+            ret->addOperatorAndConnect(op->clone(inputs, outputs));
+        }
+        return ret;
+    }
+
     void GraphObj::addOperatorAndConnect(const Operator &op)
     {
-        sorted = false;
+        opIndex.emplace(op->getGuid(), ops.size());
         ops.push_back(op);
+        bool constant = !op->getInputs().empty();
+        for (auto &input : op->getInputs())
+            constant = constant && input && input->isConstant();
         for (auto &input : op->getInputs())
         {
             if (input)
@@ -28,6 +78,7 @@ namespace infini
             if (output)
             {
                 output->setSource(op);
+                output->constant = output->constant || constant;
                 for (auto &succ : output->getTargets())
                 {
                     succ->addPredecessors(op);
@@ -35,6 +86,122 @@ namespace infini
                 }
             }
         }
+        // Appended last, so only consumers that already exist can be out of
+        // order.
+        for (auto &output : op->getOutputs())
+            if (output)
+                for (auto *succ : output->getTargetList())
+                    if (sorted && hasOperator(succ))
+                        reorderForEdge(op.get(), succ);
+    }
+
+    void GraphObj::replaceInput(const Operator &op, const Tensor &oldInput,
+                                const Tensor &newInput)
+    {
+        IT_ASSERT(hasOperator(op));
+        auto uses = std::count(op->inputs.begin(), op->inputs.end(), oldInput);
+        if (uses == 0 || oldInput == newInput)
+            return;
+        op->replaceInput(oldInput, newInput);
+        oldInput->removeTarget(op);
+        if (auto pred = oldInput->getSource())
+        {
+            op->removePredecessors(pred);
+            pred->removeSuccessors(op);
+            // Keep one link per remaining edge from the same producer.
+            for (auto &input : op->inputs)
+                if (input && input->getSource() == pred)
+                {
+                    op->addPredecessors(pred);
+                    pred->addSuccessors(op);
+                }
+        }
+        auto pred = newInput->getSource();
+        for (decltype(uses) i = 0; i < uses; ++i)
+        {
+            newInput->addTarget(op);
+            if (pred)
+            {
+                op->addPredecessors(pred);
+                pred->addSuccessors(op);
+            }
+        }
+        if (sorted && pred && hasOperator(pred.get()))
+            reorderForEdge(pred.get(), op.get());
+    }
+
+    bool GraphObj::reorderForEdge(const OperatorObj *from,
+                                  const OperatorObj *to)
+    {
+        size_t lb = opIndex.at(to->getGuid()), ub = opIndex.at(from->getGuid());
+        if (ub < lb)
+            return true;
+        // Everything reachable from `to` that is placed no later than `from`
+        // must move after everything reaching `from` placed no earlier than
+        // `to`. Both sets are gathered as positions in `ops`.
+        auto visit = [&](const OperatorObj *next, bool forward,
+                         vector<size_t> &stack, vector<bool> &seen)
+        {
+            auto it = opIndex.find(next->getGuid());
+            if (it == opIndex.end() ||
+                (forward ? it->second > ub : it->second < lb) ||
+                seen[it->second - lb])
+                return;
+            seen[it->second - lb] = true;
+            stack.emplace_back(it->second);
+        };
+        auto collect = [&](const OperatorObj *start, bool forward,
+                           vector<size_t> &found)
+        {
+            vector<bool> seen(ub - lb + 1, false);
+            vector<size_t> stack;
+            visit(start, forward, stack, seen);
+            while (!stack.empty())
+            {
+                auto pos = stack.back();
+                stack.pop_back();
+                found.emplace_back(pos);
+                auto *op = ops[pos].get();
+                if (forward)
+                {
+                    for (auto &output : op->getOutputs())
+                        for (auto *succ : output->getTargetList())
+                        {
+                            if (succ == from)
+                                return false;
+                            visit(succ, forward, stack, seen);
+                        }
+                }
+                else
+                {
+                    for (auto &input : op->getInputs())
+                        if (input)
+                            if (auto *pred = input->getSourcePtr())
+                                visit(pred, forward, stack, seen);
+                }
+            }
+            return true;
+        };
+        vector<size_t> forward, backward;
+        if (!collect(to, true, forward))
+            return sorted = false;
+        collect(from, false, backward);
+
+        std::sort(forward.begin(), forward.end());
+        std::sort(backward.begin(), backward.end());
+        vector<size_t> slots(backward);
+        slots.insert(slots.end(), forward.begin(), forward.end());
+        OpVec moved;
+        moved.reserve(slots.size());
+        for (auto pos : slots)
+            moved.emplace_back(std::move(ops[pos]));
+        std::sort(slots.begin(), slots.end());
+        for (size_t k = 0; k < slots.size(); ++k)
+        {
+            opIndex[moved[k]->getGuid()] = slots[k];
+            ops[slots[k]] = std::move(moved[k]);
+        }
+        return true;
     }
 
     string GraphObj::toString() const
@@ -48,9 +215,9 @@ namespace infini
         for (const auto &op : ops)
         {
             vector<UidBaseType> preds, succs;
-            for (auto &o : op->getPredecessors())
+            for (auto *o : op->getPredecessorList())
                 preds.emplace_back(o->getGuid());
-            for (auto &o : op->getSuccessors())
+            for (auto *o : op->getSuccessorList())
                 succs.emplace_back(o->getGuid());
             oss << "OP " << op->getGuid();
             oss << ", pred " << vecToString(preds);
@@ -66,339 +233,229 @@ namespace infini
         {
             return true;
         }
-        std::vector<Operator> sorted;
-        std::unordered_set<OperatorObj *> flags;
-        sorted.reserve(ops.size());
-        flags.reserve(ops.size());
-        while (sorted.size() < ops.size())
+        // Kahn's algorithm over the producer -> consumer edges between the
+        // operators of this graph, seeded in their current order.
+        vector<size_t> inDegree(ops.size(), 0);
+        vector<vector<size_t>> consumers(ops.size());
+        for (size_t i = 0; i < ops.size(); ++i)
         {
-            // Any node is move to sorted in this loop.
-            auto modified = false;
-            for (auto const &op : ops)
+            for (auto const &input : ops[i]->getInputs())
             {
-                if (auto const &inputs = op->getInputs();
-                    flags.find(op.get()) == flags.end() &&
-                    std::all_of(inputs.begin(), inputs.end(),
-                                [&flags](auto const &input)
-                                {
-                                    auto ptr = input->getSource().get();
-                                    return !ptr || flags.find(ptr) != flags.end();
-                                }))
+                if (!input)
+                    continue;
+                if (auto *src = input->getSourcePtr())
                 {
-                    modified = true;
-                    sorted.emplace_back(op);
-                    flags.insert(op.get());
+                    auto it = opIndex.find(src->getGuid());
+                    if (it == opIndex.end())
+                        continue;
+                    consumers[it->second].emplace_back(i);
+                    ++inDegree[i];
                 }
             }
-            if (!modified)
-            {
-                return false;
-            }
         }
+        vector<size_t> order;
+        order.reserve(ops.size());
+        for (size_t i = 0; i < ops.size(); ++i)
+            if (inDegree[i] == 0)
+                order.emplace_back(i);
+        for (size_t head = 0; head < order.size(); ++head)
+            for (auto consumer : consumers[order[head]])
+                if (--inDegree[consumer] == 0)
+                    order.emplace_back(consumer);
+        if (order.size() < ops.size())
+        {
+            return false;
+        }
+        OpVec sorted;
+        sorted.reserve(ops.size());
+        for (auto i : order)
+            sorted.emplace_back(std::move(ops[i]));
         this->ops = std::move(sorted);
+        for (size_t i = 0; i < ops.size(); ++i)
+            opIndex[ops[i]->getGuid()] = i;
         return this->sorted = true;
     }
 
-
-
-
-#include <iostream>  
-void GraphObj::optimize()
-{
-//cout是打印信息调试
-
-    // 确保图已拓扑排序，保证依赖关系正确（前序算子在前面）
-    std::cout << "[步骤1] 执行拓扑排序" << std::endl;
-    IT_ASSERT(topo_sort() == true);
-    std::cout << "[步骤1完成] 拓扑排序成功，当前算子数：" << ops.size() << "，张量数：" << tensors.size() << std::endl;
-
-    // 第一步：去除冗余的相邻Transpose算子（互为逆操作：OP8和OP9）
-    std::cout << "\n[步骤2] 开始去除冗余Transpose算子" << std::endl;
-    bool hasRedundantTranspose = true;
-    while (hasRedundantTranspose) {
-        hasRedundantTranspose = false;
-        OpVec newOps;
-        size_t i = 0;
-        std::cout << "[步骤2.1] 遍历算子列表，当前算子数：" << ops.size() << std::endl;
-        while (i < ops.size()) {
-            std::cout << "[步骤2.2] 处理算子索引 " << i << "，算子Guid：" << ops[i]->getGuid() << std::endl;
-            auto op1 = as<TransposeObj>(ops[i]);
-            if (!op1) {
-                std::cout << "[步骤2.2.1] 算子" << ops[i]->getGuid() << "不是Transpose，加入新列表" << std::endl;
-                newOps.push_back(ops[i]);
-                i++;
-                continue;
-            }
-            std::cout << "[步骤2.2.2] 算子" << ops[i]->getGuid() << "是Transpose，检查下一个算子" << std::endl;
-
-            if (i + 1 >= ops.size()) {
-                std::cout << "[步骤2.2.3] 无下一个算子，将Transpose" << ops[i]->getGuid() << "加入新列表" << std::endl;
-                newOps.push_back(ops[i]);
-                i++;
-                continue;
-            }
-            auto op2 = as<TransposeObj>(ops[i + 1]);
-            if (!op2) {
-                std::cout << "[步骤2.2.4] 下一个算子" << ops[i+1]->getGuid() << "不是Transpose，将当前Transpose加入新列表" << std::endl;
-                newOps.push_back(ops[i]);
-                i++;
-                continue;
-            }
-            std::cout << "[步骤2.2.5] 下一个算子" << ops[i+1]->getGuid() << "是Transpose，验证相邻关系" << std::endl;
-
-            Tensor op1Output = op1->getOutput();
-            Tensor op2Input = op2->getInputs(0);
-            if (op1Output != op2Input) {
-                std::cout << "[步骤2.2.6] 两个Transpose输入输出不匹配，非相邻，加入新列表" << std::endl;
-                newOps.push_back(ops[i]);
-                i++;
+    void GraphObj::propagateConstants()
+    {
+        for (const auto &op : ops)
+        {
+            const auto &inputs = op->getInputs();
+            if (inputs.empty() ||
+                !std::all_of(inputs.begin(), inputs.end(),
+                             [](const Tensor &t)
+                             { return t && t->isConstant(); }))
                 continue;
-            }
-            std::cout << "[步骤2.2.7] 两个Transpose相邻（" << op1->getGuid() << "→" << op2->getGuid() << "），检查是否为逆操作" << std::endl;
-
-            const auto& perm1 = op1->getPermute();
-            const auto& perm2 = op2->getPermute();
-            size_t rank = perm1.size();
-            bool isInverse = true;
-            if (perm1.size() != perm2.size()) {
-                isInverse = false;
-            } else {
-                for (int j = 0; j < (int)rank; j++) {
-                    if (perm2[perm1[j]] != j || perm1[perm2[j]] != j) {
-                        isInverse = false;
-                        break;
-                    }
-                }
-            }
-
-            if (isInverse) {
-                std::cout << "[步骤2.2.8] 两个Transpose是逆操作，开始删除（" << op1->getGuid() << "和" << op2->getGuid() << "）" << std::endl;
-                Tensor originalInput = op1->getInputs(0);  // i1（Guid=2）
-                Tensor finalOutput = op2->getOutput();     // t2（Guid=5）
-                std::cout << "[步骤2.2.9] originalInput（i1）Guid：" << originalInput->getGuid() << "，finalOutput（t2）Guid：" << finalOutput->getGuid() << std::endl;
-
-                // 关键：找到finalOutput的目标算子（Matmul OP11），替换输入为originalInput
-                std::cout << "[步骤2.2.10] 遍历finalOutput的目标算子，数量：" << finalOutput->getTargets().size() << std::endl;
-                for (auto& targetOp : finalOutput->getTargets()) {
-                    std::cout << "[步骤2.2.11] 处理目标算子Guid：" << targetOp->getGuid() << std::endl;
-                    auto matmulOp = as<MatmulObj>(targetOp);
-                    if (matmulOp) {
-                        std::cout << "[步骤2.2.12] 目标算子是Matmul（" << matmulOp->getGuid() << "），替换输入从" << finalOutput->getGuid() << "为" << originalInput->getGuid() << std::endl;
-
-                        matmulOp->replaceInput(finalOutput, originalInput);
-                        std::cout << "[步骤2.2.13] 清理Matmul与Transpose" << op2->getGuid() << "的依赖" << std::endl;
-
-                        matmulOp->removePredecessors(op2);
-
-                        std::cout << "[步骤2.2.14] 给originalInput添加目标算子Matmul" << std::endl;
-                        originalInput->addTarget(matmulOp);
-                    }
-                }
-
-                // 清理中间张量t1（op1Output）
-                std::cout << "[步骤2.2.15] 清理中间张量t1（Guid：" << op1Output->getGuid() << "）" << std::endl;
-                op1Output->setSource(nullptr);
-                op1Output->targets.clear();
-                std::cout << "[步骤2.2.16] 从图中移除t1" << std::endl;
-                removeTensor(op1Output);  // 移除t1（Guid=4）
-
-                // 清理中间张量t2（finalOutput）
-                std::cout << "[步骤2.2.17] 清理中间张量t2（Guid：" << finalOutput->getGuid() << "）" << std::endl;
-                finalOutput->setSource(nullptr);
-                finalOutput->targets.clear();
-                std::cout << "[步骤2.2.18] 从图中移除t2" << std::endl;
-                removeTensor(finalOutput);  // 移除t2（Guid=5）
-
-                // 清理op1的输入张量的targets（originalInput对op1的依赖）
-                originalInput->removeTarget(op1);
-                // 清理op2的输入张量的targets（op1Output对op2的依赖，已移除t1，可忽略）
-
-                // 标记已处理，跳过两个Transpose
-                std::cout << "[步骤2.2.19] 逆操作Transpose删除完成，跳过两个算子" << std::endl;
-                hasRedundantTranspose = true;
-                i += 2;
-            } else {
-                std::cout << "[步骤2.2.20] 两个Transpose非逆操作，加入新列表" << std::endl;
-                newOps.push_back(ops[i]);
-                i++;
-            }
-        }
-        std::cout << "[步骤2.3] 冗余Transpose处理完成，更新算子列表，新算子数：" << newOps.size() << std::endl;
-        ops = std::move(newOps);
-    }
-    std::cout << "[步骤2完成] 冗余Transpose删除完成，当前算子数：" << ops.size() << "，张量数：" << tensors.size() << std::endl;
-
-    // 第二步：合并Transpose到Matmul（OP10合并到Matmul的transB）
-    OpVec optimizedOps;
-    for (auto& op : ops) {
-        std::cout << "[步骤3.1] 处理算子Guid：" << op->getGuid() << "，算子类型：" << op->getOpType().toString() << std::endl;
-        auto matmulOp = as<MatmulObj>(op);
-        if (!matmulOp) {
-            std::cout << "[步骤3.1.1] 算子不是Matmul，加入优化列表" << std::endl;
-            optimizedOps.push_back(op);
-            continue;
+            for (auto &output : op->getOutputs())
+                output->constant = true;
         }
-        std::cout << "[步骤3.1.2] 算子是Matmul（" << matmulOp->getGuid() << "），处理输入B" << std::endl;
-
-        // 处理Matmul输入B（当前是t3，Guid=6，源是OP10）
-        Tensor bInput = matmulOp->getInputs(1);  // t3（Guid=6）
-        std::cout << "[步骤3.2] Matmul输入B的Guid：" << bInput->getGuid() << std::endl;
-        bool transB = matmulOp->getTransB();
-        std::cout << "[步骤3.3] 初始transB值：" << (transB ? "true" : "false") << std::endl;
-        if (auto bSourceOp = bInput->getSource()) {
-            std::cout << "[步骤3.4] 输入B的源算子Guid：" << bSourceOp->getGuid() << std::endl;
-            auto bTransOp = as<TransposeObj>(bSourceOp);  // OP10
-            if (bTransOp) {
-                std::cout << "[步骤3.5] 源算子是Transpose（" << bTransOp->getGuid() << "），验证是否为最后两维交换" << std::endl;
-                const auto& bPerm = bTransOp->getPermute();
-                size_t bRank = bPerm.size();
-                bool isLastTwoTrans = true;
-
-                // 验证：前rank-2维不变，最后两维交换（OP10的permute是{0,1,3,2}）
-                if (bRank >= 2) {
-                    for (size_t i = 0; i < bRank - 2; i++) {
-                        if (bPerm[i] != (int)i) {
-                            isLastTwoTrans = false;
-                            break;
-                        }
-                    }
-                    if (!(bPerm[bRank-2] == (int)(bRank-1) && bPerm[bRank-1] == (int)(bRank-2))) {
-                        isLastTwoTrans = false;
-                    }
-                } else {
-                    isLastTwoTrans = false;
-                }
+    }
 
-                std::cout << "[步骤3.6] Transpose" << bTransOp->getGuid() << "是否为最后两维交换：" << (isLastTwoTrans ? "是" : "否") << std::endl;
-                if (isLastTwoTrans) {
-                    // 合并Transpose到transB（原false→true）
-                    transB = !transB;
-                    std::cout << "[步骤3.7] 合并后transB值：" << (transB ? "true" : "false") << std::endl;
-                    Tensor bOrigInput = bTransOp->getInputs(0);  // i2（Guid=3）
-                    std::cout << "[步骤3.8] Transpose的原始输入（i2）Guid：" << bOrigInput->getGuid() << std::endl;
-
-                    //清理Transpose10对i2的依赖
-                    bOrigInput->removeTarget(bTransOp); 
-                    std::cout << "[步骤3.8.1] 已从i2（Guid=" << bOrigInput->getGuid() << "）的targets中移除Transpose" << bTransOp->getGuid() << std::endl;
-
-
-                    // 更新Matmul：输入B从t3改为i2
-                    std::cout << "[步骤3.9] 替换Matmul输入B从" << bInput->getGuid() << "为" << bOrigInput->getGuid() << std::endl;
-                    matmulOp->replaceInput(bInput, bOrigInput);
-                    // 清理Matmul与OP10的依赖
-                    std::cout << "[步骤3.10] 清理Matmul与Transpose" << bTransOp->getGuid() << "的依赖" << std::endl;
-                    matmulOp->removePredecessors(bTransOp);
-                    // i2添加目标算子Matmul
-                    std::cout << "[步骤3.11] 给i2添加目标算子Matmul" << std::endl;
-                    bOrigInput->addTarget(matmulOp);
-
-                    // 清理中间张量t3（bInput）
-                    std::cout << "[步骤3.12] 清理中间张量t3（Guid：" << bInput->getGuid() << "）" << std::endl;
-                    bInput->setSource(nullptr);
-                    bInput->targets.clear();
-                    std::cout << "[步骤3.13] 从图中移除t3" << std::endl;
-                    removeTensor(bInput);  // 移除t3（Guid=6）
-
-                    // 清理OP10（无需保留）
-                    std::cout << "[步骤3.14] 清理Transpose" << bTransOp->getGuid() << "的依赖" << std::endl;
-                    bTransOp->predecessors.clear();
-                    bTransOp->successors.clear();
-                    std::cout << "[步骤3.15] Transpose合并完成" << std::endl;
-                }
-            }
-        }
+    void GraphObj::optimize()
+    {
+        IT_ASSERT(topo_sort() == true);
+        // Patterns, e.g. fusion, treat constant operands differently.
+        propagateConstants();
+        PassManager::createDefault().run(*this);
+        IT_ASSERT(topo_sort() == true);
+    }
 
-        // 更新Matmul属性
-        std::cout << "[步骤3.16] 更新Matmul属性：transA=false，transB=" << (transB ? "true" : "false") << std::endl;
-        matmulOp->setTransA(false);  // 无前置Transpose，保持false
-        matmulOp->setTransB(transB); // 合并后为true
-        optimizedOps.push_back(matmulOp);
-        std::cout << "[步骤3.17] Matmul处理完成，加入优化列表" << std::endl;
-    }
-    std::cout << "[步骤3.18] 合并Transpose完成，优化列表算子数：" << optimizedOps.size() << std::endl;
-
-    // 过滤掉已合并的Transpose（OP10），仅保留Matmul
-    std::cout << "[步骤3.19] 过滤冗余Transpose，仅保留Matmul" << std::endl;
-    OpVec finalOps;
-    for (auto& op : optimizedOps) {
-        auto transOp = as<TransposeObj>(op);
-        if (!transOp) {  // 只保留Matmul
-            finalOps.push_back(op);
-            std::cout << "[步骤3.20] 保留算子Guid：" << op->getGuid() << "（非Transpose）" << std::endl;
-        } else {
-            std::cout << "[步骤3.21] 过滤掉冗余Transpose算子Guid：" << op->getGuid() << std::endl;
-        }
+    void GraphObj::eraseOperator(const Operator &op)
+    {
+        eraseOperatorInPlace(op);
+        compact();
     }
-    std::cout << "[步骤3.22] 过滤完成，最终算子数：" << finalOps.size() << std::endl;
-    ops = std::move(finalOps);
-    std::cout << "[步骤3完成] Transpose合并完成，当前算子数：" << ops.size() << "，张量数：" << tensors.size() << std::endl;
-
-    // 第三步：清理无用张量（仅保留i1、i2、o）
-    std::cout << "\n[步骤4] 开始清理无用张量，当前张量数：" << tensors.size() << std::endl;
-    TensorVec usefulTensors;
-    for (auto& tensor : tensors) {
-        std::cout << "[步骤4.1] 处理张量Guid：" << tensor->getGuid() << "，Fuid：" << tensor->getFuid() << std::endl;
-        // 过滤无效弱指针
-        vector<WRef<OperatorObj>> validTargets;
-        std::cout << "[步骤4.2] 张量" << tensor->getGuid() << "的目标算子数：" << tensor->targets.size() << std::endl;
-        for (auto& wop : tensor->targets) {
-            if (auto op = wop.lock()) {
-                validTargets.push_back(wop);
-                std::cout << "[步骤4.3] 保留有效目标算子Guid：" << op->getGuid() << std::endl;
-            } else {
-                std::cout << "[步骤4.4] 过滤无效目标算子" << std::endl;
+
+    void GraphObj::eraseOperatorInPlace(const Operator &op)
+    {
+        // Iterative, since erasing a long dead chain would recurse deeply.
+        OpVec dead{op};
+        while (!dead.empty())
+        {
+            auto cur = std::move(dead.back());
+            dead.pop_back();
+            IT_ASSERT(hasOperator(cur));
+            for (auto &output : cur->getOutputs())
+                IT_ASSERT(output->getTargetList().empty(),
+                          "Erasing an operator whose outputs are in use");
+            for (auto &input : cur->getInputs())
+                if (input)
+                    input->removeTarget(cur);
+            for (auto &pred : cur->getPredecessors())
+                pred->removeSuccessors(cur);
+            for (auto &succ : cur->getSuccessors())
+                succ->removePredecessors(cur);
+            dropOperator(cur);
+            for (auto &output : cur->getOutputs())
+                dropTensor(output);
+            for (auto &input : cur->getInputs())
+            {
+                if (!input || !hasTensor(input) ||
+                    !input->getTargetList().empty())
+                    continue;
+                auto src = input->getSource();
+                if (!src || !hasOperator(src))
+                    dropTensor(input);
+                else if (std::all_of(src->getOutputs().begin(),
+                                     src->getOutputs().end(),
+                                     [](const Tensor &t)
+                                     { return t->getTargetList().empty(); }) &&
+                         std::find(dead.begin(), dead.end(), src) == dead.end())
+                    dead.emplace_back(src);
             }
         }
-        tensor->targets = validTargets;
-        std::cout << "[步骤4.5] 过滤后有效目标算子数：" << tensor->targets.size() << std::endl;
-
-        // 有用张量判断：
-        // 1. 图输入：无源 + 有目标（i1、i2）
-        // 2. 图输出：有源（Matmul） + 无目标（o）
-        bool isInput = (tensor->getSource() == nullptr) && !tensor->targets.empty();
-        bool isOutput = (tensor->getSource() != nullptr) && tensor->targets.empty();
-        std::cout << "[步骤4.6] 张量" << tensor->getGuid() << "：是否为输入=" << (isInput ? "是" : "否") << "，是否为输出=" << (isOutput ? "是" : "否") << std::endl;
-        if (isInput || isOutput) {
-            usefulTensors.push_back(tensor);
-            std::cout << "[步骤4.7] 保留有用张量Guid：" << tensor->getGuid() << std::endl;
-        } else {
-            std::cout << "[步骤4.8] 清理无用张量Guid：" << tensor->getGuid() << std::endl;
-        }
     }
-    std::cout << "[步骤4.9] 清理完成，有用张量数：" << usefulTensors.size() << std::endl;
-    tensors = std::move(usefulTensors);
-    std::cout << "[步骤4完成] 无用张量清理完成，当前张量数：" << tensors.size() << std::endl;
 
-    // 重新拓扑排序，确保图结构正确
-    std::cout << "\n[步骤5] 重新执行拓扑排序" << std::endl;
-    sorted = false;
-    IT_ASSERT(topo_sort() == true);
-    std::cout << "[步骤5完成] 重新拓扑排序成功" << std::endl;
+    void GraphObj::replaceOperator(const Operator &op,
+                                   const Operator &replacement)
+    {
+        IT_ASSERT(hasOperator(op) && !hasOperator(replacement));
+        IT_ASSERT(replacement->getOutputs() == op->getOutputs(),
+                  "A replacement must write the outputs of the replaced op");
+        addOperatorAndConnect(replacement);
+        // Detached placeholders, so that erasing `op` keeps the real outputs.
+        for (auto &output : op->outputs)
+            output = make_ref<TensorObj>(output->getDims(), output->getDType(),
+                                         runtime);
+        eraseOperator(op);
+    }
+
+    Tensor GraphObj::getTensor(int fuid) const
+    {
+        auto it = tensorByFuid.find(fuid);
+        return it == tensorByFuid.end() ? nullptr : it->second;
+    }
 
+    bool GraphObj::hasTensor(const Tensor &tensor) const
+    {
+        return tensor && tensorIndex.count(tensor->getGuid());
+    }
 
-}
+    bool GraphObj::hasOperator(const Operator &op) const
+    {
+        return hasOperator(op.get());
+    }
 
+    bool GraphObj::hasOperator(const OperatorObj *op) const
+    {
+        return op && opIndex.count(op->getGuid());
+    }
 
+    void GraphObj::removeOperator(Operator op)
+    {
+        dropOperator(op);
+        compact();
+    }
 
+    void GraphObj::removeTensor(Tensor tensor)
+    {
+        dropTensor(tensor);
+        compact();
+    }
 
+    void GraphObj::dropOperator(const Operator &op)
+    {
+        auto it = opIndex.find(op->getGuid());
+        if (it == opIndex.end())
+            return;
+        ops[it->second] = nullptr;
+        opIndex.erase(it);
+        ++removedOps;
+    }
 
+    void GraphObj::dropTensor(const Tensor &tensor)
+    {
+        auto it = tensorIndex.find(tensor->getGuid());
+        if (it == tensorIndex.end())
+            return;
+        tensors[it->second] = nullptr;
+        tensorIndex.erase(it);
+        auto fuidIt = tensorByFuid.find(tensor->getFuid());
+        if (fuidIt != tensorByFuid.end() && fuidIt->second == tensor)
+            tensorByFuid.erase(fuidIt);
+        ++removedTensors;
+    }
 
+    void GraphObj::compact()
+    {
+        if (removedTensors)
+        {
+            tensors.erase(std::remove(tensors.begin(), tensors.end(), nullptr),
+                          tensors.end());
+            for (size_t i = 0; i < tensors.size(); ++i)
+                tensorIndex[tensors[i]->getGuid()] = i;
+            removedTensors = 0;
+        }
+        if (removedOps)
+        {
+            ops.erase(std::remove(ops.begin(), ops.end(), nullptr), ops.end());
+            for (size_t i = 0; i < ops.size(); ++i)
+                opIndex[ops[i]->getGuid()] = i;
+            removedOps = 0;
+        }
+    }
 
-    Tensor GraphObj::getTensor(int fuid) const
+    void GraphObj::reindex()
     {
-        for (auto tensor : tensors)
+        removedTensors = removedOps = 0;
+        tensors.erase(std::remove(tensors.begin(), tensors.end(), nullptr),
+                      tensors.end());
+        ops.erase(std::remove(ops.begin(), ops.end(), nullptr), ops.end());
+        tensorIndex.clear();
+        tensorByFuid.clear();
+        opIndex.clear();
+        for (size_t i = 0; i < tensors.size(); ++i)
         {
-            if (tensor->getFuid() == fuid)
-            {
-                return tensor;
-            }
+            tensorIndex.emplace(tensors[i]->getGuid(), i);
+            tensorByFuid.emplace(tensors[i]->getFuid(), tensors[i]);
         }
-        return nullptr;
+        for (size_t i = 0; i < ops.size(); ++i)
+            opIndex.emplace(ops[i]->getGuid(), i);
     }
 
     void GraphObj::shape_infer()
     {
-        for (auto &op : ops)
+        for (auto &op : getOperators())
         {
             auto ans = op->inferShape();
             IT_ASSERT(ans.has_value());
@@ -419,50 +476,242 @@ void GraphObj::optimize()
         }
     }
 
-void GraphObj::dataMalloc()
-{
-    // topological sorting first
-    IT_ASSERT(topo_sort() == true);
+    // The tensor whose buffer `tensor` lives in: views share their input's.
+    static Tensor bufferOf(Tensor tensor)
+    {
+        for (auto *src = tensor->getSourcePtr(); src && src->getAliasOffset();
+             src = tensor->getSourcePtr())
+            tensor = src->getInputs(0);
+        return tensor;
+    }
+
+    void GraphObj::dataMalloc()
+    {
+        IT_ASSERT(topo_sort() == true);
+        if (!arena)
+            arena = make_ref<ArenaObj>(runtime);
 
-    // =================================== 作业实现 ===================================
-    // 1. 收集所有张量，按拓扑顺序分配（确保输入张量先分配）
-    TensorVec allTensors = getTensors();
+        // Constants are placed once, on the first call, and never move.
+        if (!weights)
+        {
+            // Weights are often marked after their readers were added.
+            propagateConstants();
+            weights = std::make_shared<Allocator>(runtime);
+            TensorVec constants;
+            for (const auto &tensor : getTensors())
+                if (tensor->isConstant() && tensor->getBytes() != 0 &&
+                    bufferOf(tensor) == tensor)
+                    constants.emplace_back(tensor);
+            vector<size_t> offsets;
+            for (const auto &tensor : constants)
+                offsets.emplace_back(weights->alloc(tensor->getBytes()));
+            auto base = static_cast<char *>(weights->getPtr());
+            for (size_t i = 0; i < constants.size(); ++i)
+                constants[i]->setDataBlob(
+                    make_ref<BlobObj>(runtime, base + offsets[i]));
+        }
 
-    // 2. 为每个张量分配内存，记录偏移量
-    std::unordered_map<Tensor, size_t> tensorOffsets;
-    for (const auto &tensor : allTensors)
+        // Constants keep their shapes, and foldConstants replaces them.
+        vector<Shape> signature;
+        for (const auto &input : getInputs())
+            if (!input->isConstant())
+                signature.emplace_back(input->getDims());
+        auto cached = plans.find(signature);
+        if (cached == plans.end())
+        {
+            cached = plans.emplace(signature, MemoryPlan()).first;
+            MemoryPlan &plan = cached->second;
+            // Inputs and outputs keep their data between runs, so they stay
+            // out of the arena, along with the tensors outputs are views of.
+            TensorVec io;
+            for (const auto &tensor : getTensors())
+            {
+                auto buffer = bufferOf(tensor);
+                if (buffer->isConstant() || buffer->getBytes() == 0 ||
+                    (tensor->getSourcePtr() &&
+                     !tensor->getTargetList().empty()) ||
+                    std::find(io.begin(), io.end(), buffer) != io.end())
+                    continue;
+                io.emplace_back(buffer);
+            }
+            plan.io = std::make_unique<Allocator>(runtime);
+            vector<size_t> offsets;
+            for (const auto &tensor : io)
+                offsets.emplace_back(plan.io->alloc(tensor->getBytes()));
+            auto base = static_cast<char *>(plan.io->getPtr());
+            for (size_t i = 0; i < io.size(); ++i)
+                plan.blobs.emplace_back(
+                    io[i], make_ref<BlobObj>(runtime, base + offsets[i]));
+            planActivations(plan);
+        }
+        bindPlan(cached->second);
+    }
+
+    void GraphObj::planActivations(MemoryPlan &plan)
     {
-        size_t bytes = tensor->getBytes();
-        if (bytes == 0)
-            continue;
+        std::unordered_set<const TensorObj *> bound;
+        for (const auto &[tensor, blob] : plan.blobs)
+            bound.emplace(tensor.get());
+        // Position of the last operator reading each buffer, directly or
+        // through views.
+        const auto &ops = getOperators();
+        std::unordered_map<const TensorObj *, size_t> lastUse;
+        for (size_t i = 0; i < ops.size(); ++i)
+            for (const auto &input : ops[i]->getInputs())
+                lastUse[bufferOf(input).get()] = i;
+
+        Allocator allocator(runtime);
+        std::unordered_map<const TensorObj *, size_t> live;
+        plan.offsets.clear();
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            // Outputs are placed before the inputs' space is released, so
+            // no kernel writes over what it reads.
+            for (const auto &output : ops[i]->getOutputs())
+            {
+                if (output->isConstant() || output->getBytes() == 0 ||
+                    bound.count(output.get()) || bufferOf(output) != output)
+                    continue;
+                size_t offset = allocator.alloc(output->getBytes());
+                live.emplace(output.get(), offset);
+                plan.offsets.emplace_back(output, offset);
+            }
+            for (const auto &input : ops[i]->getInputs())
+            {
+                auto buffer = bufferOf(input);
+                auto it = live.find(buffer.get());
+                if (it != live.end() && lastUse.at(buffer.get()) == i)
+                {
+                    allocator.free(it->second, buffer->getBytes());
+                    live.erase(it);
+                }
+            }
+        }
+        plan.arenaBytes = allocator.getPeak();
+    }
 
-        size_t offset = allocator.alloc(bytes);
-        tensorOffsets[tensor] = offset;
+    void GraphObj::bindPlan(MemoryPlan &plan)
+    {
+        for (const auto &[tensor, blob] : plan.blobs)
+            tensor->setDataBlob(blob);
+        auto base = static_cast<char *>(arena->reserve(plan.arenaBytes));
+        for (const auto &[tensor, offset] : plan.offsets)
+            tensor->setDataBlob(make_ref<BlobObj>(runtime, base + offset));
+        // Views point into their input, whose buffer is bound first in
+        // topological order.
+        for (const auto &op : getOperators())
+        {
+            auto offset = op->getAliasOffset();
+            auto input = op->getInputs(0);
+            if (!offset || input->getBytes() == 0)
+                continue;
+            auto ptr = input->getRawDataPtr<char *>() +
+                       *offset * input->getDType().getSize();
+            op->getOutput()->setDataBlob(make_ref<BlobObj>(runtime, ptr));
+        }
+        boundPlan = &plan;
+        boundGeneration = arena->getGeneration();
     }
 
-    // 3. 调用 getPtr() 实际分配内存（一次性分配峰值内存）
-    void *basePtr = allocator.getPtr();
+    void GraphObj::bindActivations()
+    {
+        if (boundPlan && boundGeneration != arena->getGeneration())
+            bindPlan(*boundPlan);
+    }
 
-    // 4. 为每个张量绑定内存块（Blob 封装内存指针）
-    for (const auto &tensor : allTensors)
+    void GraphObj::setArena(Arena arena)
     {
-        size_t bytes = tensor->getBytes();
-        if (bytes == 0)
-            continue;
+        this->arena = std::move(arena);
+        if (boundPlan)
+            bindPlan(*boundPlan);
+    }
 
-        size_t offset = tensorOffsets[tensor];
-        void *tensorPtr = static_cast<char *>(basePtr) + offset; // 计算张量实际地址
-        Blob blob = make_ref<BlobObj>(runtime, tensorPtr);
-        tensor->setDataBlob(blob); // 绑定内存到张量
+    void GraphObj::resize(const TensorVec &inputs, const vector<Shape> &dims)
+    {
+        IT_ASSERT(inputs.size() == dims.size());
+        IT_ASSERT(!plans.empty(), "Graphs are resized after dataMalloc");
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            IT_ASSERT(hasTensor(inputs[i]) && !inputs[i]->getSourcePtr() &&
+                          !inputs[i]->isConstant(),
+                      "Only graph inputs that are not constant are resized");
+            inputs[i]->setShape(dims[i]);
+        }
+        shape_infer();
+        dataMalloc();
     }
-    // =================================== 作业实现 ===================================
 
-    allocator.info();
-}
+    size_t GraphObj::foldConstants()
+    {
+        IT_ASSERT(topo_sort() == true);
+        const auto &registry = KernelRegistry::getInstance();
+        OpVec folded;
+        auto isConstant = [](const Tensor &t) { return t->isConstant(); };
+        for (auto &op : getOperators())
+        {
+            const auto &inputs = op->getInputs();
+            const auto &outputs = op->getOutputs();
+            // Outputs marked constant when the op was added live in the
+            // weight region; the others were planned as activations, and
+            // graph outputs would be left with neither producer nor reader.
+            if (inputs.empty() ||
+                !std::all_of(inputs.begin(), inputs.end(), isConstant) ||
+                !std::all_of(outputs.begin(), outputs.end(), isConstant) ||
+                std::any_of(outputs.begin(), outputs.end(),
+                            [](const Tensor &t)
+                            { return t->getTargetList().empty(); }))
+                continue;
+            for (auto &tensor : inputs)
+                IT_ASSERT(tensor->data != nullptr,
+                          "Constants are folded after dataMalloc");
+            auto kernel = registry.getKernel(
+                {runtime->getDevice(), op->getOpType().underlying()});
+            kernel->compute(op, runtime.get());
+            folded.emplace_back(op);
+        }
+        // Producers first, so each output is detached before its consumers
+        // are erased and it can be dropped with them if nothing else reads it.
+        for (auto &op : folded)
+        {
+            for (auto &output : op->outputs)
+            {
+                output->source.reset();
+                output->sourcePtr = nullptr;
+                output = make_ref<TensorObj>(output->getDims(),
+                                             output->getDType(), runtime);
+            }
+            eraseOperatorInPlace(op);
+        }
+        compact();
+        PassManager::createLoadTime().run(*this);
+        // Readers moved, and with them the last uses of intermediates, so
+        // the current plan is made again and those of other shapes dropped.
+        if (boundPlan)
+        {
+            for (auto it = plans.begin(); it != plans.end();)
+                it = &it->second == boundPlan ? std::next(it) : plans.erase(it);
+            planActivations(*boundPlan);
+            bindPlan(*boundPlan);
+        }
+        return folded.size();
+    }
+
+    size_t GraphObj::packConstants()
+    {
+        const auto &registry = KernelRegistry::getInstance();
+        size_t ret = 0;
+        for (auto &op : getOperators())
+        {
+            auto kernel = registry.getKernel(
+                {runtime->getDevice(), op->getOpType().underlying()});
+            ret += kernel->packConstants(op, runtime.get());
+        }
+        return ret;
+    }
 
     Tensor GraphObj::addTensor(Shape dim, DataType dtype)
     {
-        return tensors.emplace_back(make_ref<TensorObj>(dim, dtype, runtime));
+        return addTensor(make_ref<TensorObj>(dim, dtype, runtime));
     }
 
     Tensor GraphObj::addTensor(const Tensor &tensor)
@@ -471,6 +720,12 @@ void GraphObj::dataMalloc()
                   std::string("Tensor runtime mismatch: cannot add a tenosr in ") +
                       tensor->getRuntime()->toString() + " to " +
                       runtime->toString());
+        IT_ASSERT(!hasTensor(tensor), "Tensor " +
+                                          std::to_string(tensor->getGuid()) +
+                                          " is already in the graph");
+        tensorIndex.emplace(tensor->getGuid(), tensors.size());
+        // Cloned tensors share a fuid; checkValid reports the duplicate.
+        tensorByFuid.emplace(tensor->getFuid(), tensor);
         tensors.emplace_back(tensor);
         return tensor;
     }
@@ -490,43 +745,41 @@ void GraphObj::dataMalloc()
     {
         for (auto tensor : tensors)
         {
-            IT_ASSERT(!(tensor->getTargets().size() == 0 &&
-                        nullptr == tensor->getSource()));
-            for (auto op : tensor->getTargets())
+            IT_ASSERT(!(tensor->getTargetList().empty() &&
+                        nullptr == tensor->getSourcePtr()));
+            for (auto *op : tensor->getTargetList())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), op) != ops.end());
+                IT_ASSERT(hasOperator(op));
             }
-            auto op = tensor->getSource();
-            IT_ASSERT(!(op && std::find(ops.begin(), ops.end(), op) == ops.end()));
+            auto *op = tensor->getSourcePtr();
+            IT_ASSERT(!(op && !hasOperator(op)));
         }
         for (auto op : ops)
         {
             for (auto tensor : op->getInputs())
             {
-                IT_ASSERT(std::find(tensors.begin(), tensors.end(), tensor) !=
-                          tensors.end());
+                IT_ASSERT(hasTensor(tensor));
             }
             for (auto tensor : op->getOutputs())
             {
-                IT_ASSERT(std::find(tensors.begin(), tensors.end(), tensor) !=
-                          tensors.end());
+                IT_ASSERT(hasTensor(tensor));
             }
-            for (auto pre : op->getPredecessors())
+            for (auto *pre : op->getPredecessorList())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), pre) != ops.end());
+                IT_ASSERT(hasOperator(pre));
             }
-            for (auto suc : op->getSuccessors())
+            for (auto *suc : op->getSuccessorList())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), suc) != ops.end());
+                IT_ASSERT(hasOperator(suc));
             }
         }
-        std::set<UidBaseType> s;
+        std::unordered_set<UidBaseType> s;
+        s.reserve(tensors.size());
         // check whether two tensors with the same FUID exist
         for (auto tensor : tensors)
         {
-            int cnt = s.count(tensor->getFuid());
-            IT_ASSERT(cnt == 0, std::to_string(tensor->getFuid()));
-            s.insert(tensor->getFuid());
+            IT_ASSERT(s.insert(tensor->getFuid()).second,
+                      std::to_string(tensor->getFuid()));
         }
         return true;
     }
@@ -9,24 +9,12 @@ namespace infini
 
     void OperatorObj::removePredecessors(const Operator &op)
     {
-        for (auto it = predecessors.begin(); it != predecessors.end();)
-        {
-            if (it->lock() == op)
-                it = predecessors.erase(it);
-            else
-                ++it;
-        }
+        predecessors.remove(op.get());
     }
 
     void OperatorObj::removeSuccessors(const Operator &op)
     {
-        for (auto it = successors.begin(); it != successors.end();)
-        {
-            if (it->lock() == op)
-                it = successors.erase(it);
-            else
-                ++it;
-        }
+        successors.remove(op.get());
     }
 
     void OperatorObj::replaceInput(Tensor t1, Tensor t2)
@@ -69,6 +57,24 @@ namespace infini
         return true;
     }
 
+    OpCost OperatorObj::getCost() const
+    {
+        OpCost cost;
+        for (auto &input : inputs)
+            cost.bytes += input->getBytes();
+        for (auto &output : outputs)
+        {
+            cost.flops += output->size();
+            cost.bytes += output->getBytes();
+        }
+        return cost;
+    }
+
+    vector<int> OperatorObj::getOpAttrVector() const
+    {
+        return {type.underlying()};
+    }
+
     optional<vector<Shape>> OperatorObj::inferShape() { return inferShape(inputs); }
 
     vector<DataType> OperatorObj::inferDataType(const TensorVec &inputs) const
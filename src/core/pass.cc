@@ -0,0 +1,208 @@
+#include "core/pass.h"
+#include "utils/logging.h"
+#include <chrono>
+#include <deque>
+#include <iomanip>
+
+namespace infini
+{
+
+    void PatternRewriter::replaceInput(const Operator &op,
+                                       const Tensor &oldInput,
+                                       const Tensor &newInput)
+    {
+        graph.replaceInput(op, oldInput, newInput);
+        notify(op);
+        if (auto src = newInput->getSource())
+            if (graph.hasOperator(src))
+                notify(src);
+    }
+
+    void PatternRewriter::replaceAllUses(const Tensor &from, const Tensor &to)
+    {
+        for (auto &op : from->getTargets())
+            if (graph.hasOperator(op))
+                replaceInput(op, from, to);
+    }
+
+    bool PatternRewriter::replaceOpWithValue(const Operator &op,
+                                             const Tensor &value)
+    {
+        auto output = op->getOutput();
+        IT_ASSERT(value->getDims() == output->getDims() &&
+                  value->getDType() == output->getDType());
+        if (output->getTargetList().empty())
+            return false;
+        replaceAllUses(output, value);
+        eraseOp(op);
+        return true;
+    }
+
+    void PatternRewriter::eraseOp(const Operator &op)
+    {
+        TensorVec inputs = op->getInputs();
+        graph.eraseOperator(op);
+        notifyProducers(inputs);
+    }
+
+    void PatternRewriter::notifyProducers(const TensorVec &tensors)
+    {
+        for (auto &tensor : tensors)
+            if (tensor && graph.hasTensor(tensor))
+                if (auto src = tensor->getSource())
+                    if (graph.hasOperator(src))
+                        notify(src);
+    }
+
+    PatternRewritePass::PatternRewritePass(
+        string name, vector<std::shared_ptr<RewritePattern>> patterns)
+        : Pass(std::move(name))
+    {
+        auto byBenefit = [](const std::shared_ptr<RewritePattern> &a,
+                            const std::shared_ptr<RewritePattern> &b)
+        { return a->getBenefit() > b->getBenefit(); };
+        for (auto &pattern : patterns)
+        {
+            if (pattern->getRootTypes().empty())
+                generic.emplace_back(pattern);
+            for (auto type : pattern->getRootTypes())
+                byRoot[type.underlying()].emplace_back(pattern);
+        }
+        for (auto &[type, list] : byRoot)
+        {
+            list.insert(list.end(), generic.begin(), generic.end());
+            std::stable_sort(list.begin(), list.end(), byBenefit);
+        }
+        std::stable_sort(generic.begin(), generic.end(), byBenefit);
+    }
+
+    bool PatternRewritePass::run(GraphObj &graph, PassStatistics &stats)
+    {
+        IT_ASSERT(graph.topo_sort() == true);
+        std::deque<Operator> worklist;
+        std::unordered_set<UidBaseType> queued;
+        auto push = [&](const Operator &op)
+        {
+            if (queued.insert(op->getGuid()).second)
+                worklist.emplace_back(op);
+        };
+        for (auto &op : graph.getOperators())
+            push(op);
+        PatternRewriter rewriter(graph, push);
+
+        // A guard against patterns undoing each other forever.
+        size_t budget = 16 * (worklist.size() + 1);
+        bool changed = false;
+        while (!worklist.empty())
+        {
+            auto op = std::move(worklist.front());
+            worklist.pop_front();
+            queued.erase(op->getGuid());
+            if (!graph.hasOperator(op))
+                continue;
+            auto it = byRoot.find(op->getOpType().underlying());
+            const auto &candidates = it == byRoot.end() ? generic : it->second;
+            for (auto &pattern : candidates)
+            {
+                if (!pattern->matchAndRewrite(op, rewriter))
+                    continue;
+                IT_LOG(Debug, getName() << ": " << pattern->getName()
+                                        << " rewrote op " << op->getGuid());
+                ++stats.counters[pattern->getName()];
+                changed = true;
+                if (graph.hasOperator(op))
+                    push(op);
+                if (--budget == 0)
+                {
+                    IT_LOG(Warn, getName()
+                                     << ": rewrite budget exhausted, patterns "
+                                        "may be cycling");
+                    return true;
+                }
+                break;
+            }
+        }
+        return changed;
+    }
+
+    void PassManager::addPass(std::unique_ptr<Pass> pass)
+    {
+        PassStatistics s;
+        s.name = pass->getName();
+        stats.emplace_back(std::move(s));
+        passes.emplace_back(std::move(pass));
+    }
+
+    bool PassManager::run(GraphObj &graph)
+    {
+        bool changedAny = false;
+        for (int iter = 0; iter < maxIterations; ++iter)
+        {
+            bool changed = false;
+            for (size_t i = 0; i < passes.size(); ++i)
+            {
+                auto start = std::chrono::steady_clock::now();
+                bool c = passes[i]->run(graph, stats[i]);
+                double ms = std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+                ++stats[i].runs;
+                stats[i].totalMs += ms;
+                IT_LOG(Info, "pass " << passes[i]->getName()
+                                     << (c ? " changed" : " unchanged")
+                                     << " the graph in " << ms << " ms, "
+                                     << graph.getOperators().size() << " ops");
+                if (c)
+                {
+                    ++stats[i].changes;
+                    if (verify)
+                        IT_ASSERT(graph.checkValid() && graph.topo_sort(),
+                                  "Graph invalid after " +
+                                      passes[i]->getName());
+                }
+                changed |= c;
+            }
+            if (!changed)
+                break;
+            changedAny = true;
+        }
+        return changedAny;
+    }
+
+    string PassManager::statistics() const
+    {
+        std::ostringstream oss;
+        oss << std::left << std::setw(28) << "Pass" << std::right
+            << std::setw(8) << "Runs" << std::setw(10) << "Changed"
+            << std::setw(12) << "Time(ms)" << "\n";
+        oss << std::fixed << std::setprecision(3);
+        for (auto &s : stats)
+        {
+            oss << std::left << std::setw(28) << s.name << std::right
+                << std::setw(8) << s.runs << std::setw(10) << s.changes
+                << std::setw(12) << s.totalMs << "\n";
+            for (auto &[counter, value] : s.counters)
+                oss << "  " << std::left << std::setw(26) << counter
+                    << std::right << std::setw(8) << value << "\n";
+        }
+        return oss.str();
+    }
+
+    PassManager PassManager::createDefault()
+    {
+        PassManager pm;
+        pm.addPass<CommonSubexpressionElimination>();
+        pm.addPass<PatternRewritePass>(
+            "Canonicalize", PatternRegistry::getInstance().getPatterns());
+        return pm;
+    }
+
+    PassManager PassManager::createLoadTime()
+    {
+        PassManager pm;
+        pm.addPass<PatternRewritePass>(
+            "LoadTime", PatternRegistry::getInstance().getLoadPatterns());
+        return pm;
+    }
+
+} // namespace infini
@@ -0,0 +1,103 @@
+#include "core/perf_counters.h"
+#include <cerrno>
+#include <cstring>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace infini
+{
+    uint64_t CounterValues::estimatedDramBytes() const
+    {
+#if defined(__linux__) && defined(_SC_LEVEL3_CACHE_LINESIZE)
+        static const long line = sysconf(_SC_LEVEL3_CACHE_LINESIZE);
+        return llcMisses * (line > 0 ? line : 64);
+#else
+        return llcMisses * 64;
+#endif
+    }
+
+#ifdef __linux__
+    namespace
+    {
+        constexpr uint64_t kEvents[] = {PERF_COUNT_HW_CPU_CYCLES,
+                                        PERF_COUNT_HW_INSTRUCTIONS,
+                                        PERF_COUNT_HW_CACHE_MISSES};
+        constexpr int kNumEvents = sizeof(kEvents) / sizeof(kEvents[0]);
+
+        int openEvent(uint64_t config, int tid, int groupFd)
+        {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP |
+                               PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return syscall(SYS_perf_event_open, &attr, tid, -1, groupFd, 0);
+        }
+    } // namespace
+
+    PerfCounters::PerfCounters(const vector<int> &tids)
+    {
+        for (int tid : tids)
+        {
+            vector<int> fds;
+            for (int i = 0; i < kNumEvents; ++i)
+            {
+                int fd = openEvent(kEvents[i], tid, fds.empty() ? -1 : fds[0]);
+                if (fd < 0)
+                {
+                    error = string("perf_event_open: ") + strerror(errno);
+                    for (int opened : fds)
+                        close(opened);
+                    return;
+                }
+                fds.emplace_back(fd);
+            }
+            groups.emplace_back(std::move(fds));
+        }
+        available = true;
+    }
+
+    PerfCounters::~PerfCounters()
+    {
+        for (auto &fds : groups)
+            for (int fd : fds)
+                close(fd);
+    }
+
+    CounterValues PerfCounters::read() const
+    {
+        CounterValues ret;
+        if (!available)
+            return ret;
+        for (auto &fds : groups)
+        {
+            uint64_t buf[3 + kNumEvents];
+            if (::read(fds[0], buf, sizeof(buf)) != sizeof(buf))
+                continue;
+            double enabled = buf[1], running = buf[2];
+            double scale = running > 0 ? enabled / running : 0.;
+            ret.cycles += uint64_t(buf[3] * scale);
+            ret.instructions += uint64_t(buf[4] * scale);
+            ret.llcMisses += uint64_t(buf[5] * scale);
+        }
+        return ret;
+    }
+#else
+    PerfCounters::PerfCounters(const vector<int> &tids)
+        : error("perf_event_open is only available on Linux") {}
+
+    PerfCounters::~PerfCounters() {}
+
+    CounterValues PerfCounters::read() const { return {}; }
+#endif
+
+} // namespace infini
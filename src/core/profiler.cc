@@ -0,0 +1,217 @@
+#include "core/profiler.h"
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+
+namespace infini
+{
+    namespace
+    {
+        string jsonEscape(const string &str)
+        {
+            string ret;
+            for (char c : str)
+            {
+                if (c == '"' || c == '\\')
+                    ret += '\\';
+                ret += c;
+            }
+            return ret;
+        }
+    } // namespace
+
+    int Profiler::currentThreadId()
+    {
+        static std::atomic<int> nextId{0};
+        thread_local int id = nextId++;
+        return id;
+    }
+
+    void Profiler::record(ProfileRecord record)
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        records.emplace_back(std::move(record));
+    }
+
+    void Profiler::setCounterError(const string &error)
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        counterError = error;
+    }
+
+    void Profiler::clear()
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        records.clear();
+        counterError.clear();
+        epoch = Clock::now();
+    }
+
+    vector<ProfileRecord> Profiler::getRecords() const
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        return records;
+    }
+
+    double Profiler::toUs(Clock::time_point t) const
+    {
+        return std::chrono::duration<double, std::micro>(t - epoch).count();
+    }
+
+    string Profiler::summary() const
+    {
+        struct Entry
+        {
+            size_t calls = 0;
+            double totalUs = 0;
+            size_t bytes = 0;
+            CounterValues counters;
+        };
+        std::map<string, Entry> byType;
+        double totalUs = 0;
+        size_t totalCalls = 0;
+        bool hasCounters = false;
+        for (auto &r : getRecords())
+        {
+            totalCalls++;
+            auto &e = byType[r.opType.toString()];
+            e.calls++;
+            e.totalUs += r.durationUs;
+            totalUs += r.durationUs;
+            if (r.hasCounters)
+            {
+                hasCounters = true;
+                e.bytes += r.cost.bytes;
+                e.counters += r.counters;
+            }
+        }
+        vector<pair<string, Entry>> rows(byType.begin(), byType.end());
+        std::sort(rows.begin(), rows.end(), [](auto &a, auto &b)
+                  { return a.second.totalUs > b.second.totalUs; });
+
+        std::ostringstream os;
+        os << std::left << std::setw(16) << "Op" << std::right << std::setw(8)
+           << "Calls" << std::setw(14) << "Total(ms)" << std::setw(12)
+           << "Avg(us)" << std::setw(9) << "%";
+        if (hasCounters)
+            os << std::setw(8) << "IPC" << std::setw(12) << "Miss/KB"
+               << std::setw(12) << "DRAM GB/s";
+        os << "\n" << std::fixed;
+        for (auto &[type, e] : rows)
+        {
+            os << std::left << std::setw(16) << type << std::right
+               << std::setw(8) << e.calls << std::setw(14)
+               << std::setprecision(3) << e.totalUs / 1e3 << std::setw(12)
+               << std::setprecision(2) << e.totalUs / e.calls << std::setw(9)
+               << std::setprecision(2)
+               << (totalUs > 0 ? 100 * e.totalUs / totalUs : 0.);
+            if (hasCounters)
+                os << std::setw(8) << e.counters.ipc() << std::setw(12)
+                   << (e.bytes ? 1024. * e.counters.llcMisses / e.bytes : 0.)
+                   << std::setw(12)
+                   << (e.totalUs > 0
+                           ? e.counters.estimatedDramBytes() / e.totalUs / 1e3
+                           : 0.);
+            os << "\n";
+        }
+        os << std::left << std::setw(16) << "Total" << std::right
+           << std::setw(8) << totalCalls << std::setw(14)
+           << std::setprecision(3) << totalUs / 1e3 << "\n";
+        std::lock_guard<std::mutex> lk(mtx);
+        if (!counterError.empty())
+            os << "Hardware counters unavailable: " << counterError << "\n";
+        return os.str();
+    }
+
+    void Profiler::printSummary() const { std::cout << summary(); }
+
+    string Profiler::toChromeTrace() const
+    {
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(3);
+        os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        for (auto &r : getRecords())
+        {
+            os << (first ? "" : ",") << "\n{\"name\":\"" << r.opType.toString()
+               << "\",\"cat\":\"op\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+               << r.threadId << ",\"ts\":" << r.startUs
+               << ",\"dur\":" << r.durationUs << ",\"args\":{\"guid\":"
+               << r.opGuid << ",\"kernel\":\"" << jsonEscape(r.kernelName)
+               << "\",\"dtype\":\"" << r.dtype.toString()
+               << "\",\"threads\":" << r.numThreads << ",\"inputs\":\"";
+            for (size_t i = 0; i < r.inputShapes.size(); ++i)
+                os << (i ? "," : "") << vecToString(r.inputShapes[i]);
+            os << "\"";
+            if (r.hasCounters)
+                os << ",\"cycles\":" << r.counters.cycles
+                   << ",\"instructions\":" << r.counters.instructions
+                   << ",\"llc_misses\":" << r.counters.llcMisses;
+            os << "}}";
+            first = false;
+        }
+        os << "\n]}\n";
+        return os.str();
+    }
+
+    string Profiler::rooflineReport(const Roofline &machine) const
+    {
+        struct Entry
+        {
+            OpType type = OpType::Unknown;
+            size_t calls = 0;
+            double totalUs = 0;
+            OpCost cost;
+        };
+        std::map<UidBaseType, Entry> byOp;
+        double totalUs = 0;
+        for (auto &r : getRecords())
+        {
+            auto &e = byOp[r.opGuid];
+            e.type = r.opType;
+            e.calls++;
+            e.totalUs += r.durationUs;
+            e.cost = r.cost;
+            totalUs += r.durationUs;
+        }
+        vector<pair<UidBaseType, Entry>> rows(byOp.begin(), byOp.end());
+        std::sort(rows.begin(), rows.end(), [](auto &a, auto &b)
+                  { return a.second.totalUs > b.second.totalUs; });
+
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(2);
+        os << "Machine: " << machine.peakGflops << " GFLOP/s, "
+           << machine.bandwidthGBs << " GB/s\n";
+        os << std::left << std::setw(12) << "Op" << std::right << std::setw(8)
+           << "Guid" << std::setw(12) << "Avg(us)" << std::setw(8) << "Time%"
+           << std::setw(10) << "FLOP/B" << std::setw(11) << "GFLOP/s"
+           << std::setw(9) << "GB/s" << std::setw(8) << "%Roof" << "\n";
+        for (auto &[guid, e] : rows)
+        {
+            double avgUs = e.totalUs / e.calls;
+            double gflops = avgUs > 0 ? e.cost.flops / avgUs / 1e3 : 0.;
+            double gbs = avgUs > 0 ? e.cost.bytes / avgUs / 1e3 : 0.;
+            double intensity =
+                e.cost.bytes ? double(e.cost.flops) / e.cost.bytes : 0.;
+            // Data movement ops are judged against bandwidth alone.
+            double roof =
+                e.cost.flops
+                    ? gflops / std::max(machine.attainableGflops(intensity), 1e-9)
+                    : gbs / std::max(machine.bandwidthGBs, 1e-9);
+            os << std::left << std::setw(12) << e.type.toString() << std::right
+               << std::setw(8) << guid << std::setw(12) << avgUs << std::setw(8)
+               << (totalUs > 0 ? 100 * e.totalUs / totalUs : 0.)
+               << std::setw(10) << intensity << std::setw(11) << gflops
+               << std::setw(9) << gbs << std::setw(8) << 100 * roof << "\n";
+        }
+        return os.str();
+    }
+
+    void Profiler::dumpChromeTrace(const string &path) const
+    {
+        std::ofstream file(path);
+        IT_ASSERT(file.is_open(), "Cannot open " + path);
+        file << toChromeTrace();
+    }
+
+} // namespace infini
@@ -0,0 +1,76 @@
+#include "core/roofline.h"
+#include <chrono>
+
+namespace infini
+{
+    namespace
+    {
+        constexpr int kRepeats = 5;
+        // Independent accumulators, enough to hide FMA latency and fill the
+        // vector lanes once the compiler vectorises the inner loop.
+        constexpr int kLanes = 64;
+        constexpr size_t kFmaIters = size_t(1) << 16;
+
+        template <typename F> double bestSeconds(F &&f)
+        {
+            double best = 1e30;
+            for (int r = 0; r < kRepeats; ++r)
+            {
+                auto start = std::chrono::steady_clock::now();
+                f();
+                auto end = std::chrono::steady_clock::now();
+                best = std::min(
+                    best, std::chrono::duration<double>(end - start).count());
+            }
+            return best;
+        }
+
+        float fmaChains(float seed)
+        {
+            float acc[kLanes];
+            for (int j = 0; j < kLanes; ++j)
+                acc[j] = seed + j;
+            const float a = 0.999f, b = 1e-3f;
+            for (size_t i = 0; i < kFmaIters; ++i)
+                for (int j = 0; j < kLanes; ++j)
+                    acc[j] = acc[j] * a + b;
+            float sum = 0;
+            for (int j = 0; j < kLanes; ++j)
+                sum += acc[j];
+            return sum;
+        }
+    } // namespace
+
+    Roofline probeRoofline(ThreadPool &pool, size_t bytesPerArray)
+    {
+        Roofline ret;
+        size_t n = std::max<size_t>(1, bytesPerArray / sizeof(float));
+        vector<float> a(n), b(n, 1.f), c(n, 2.f);
+        const float scalar = 3.f;
+        auto triadRange = [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                a[i] = b[i] + scalar * c[i];
+        };
+        double triad =
+            bestSeconds([&] { pool.parallel_for(0, n, 1 << 14, triadRange); });
+        ret.bandwidthGBs = 3. * n * sizeof(float) / triad / 1e9;
+
+        int threads = pool.getNumThreads();
+        vector<float> sink(threads);
+        auto fmaRange = [&](size_t begin, size_t end)
+        {
+            for (size_t t = begin; t < end; ++t)
+                sink[t] = fmaChains(float(t));
+        };
+        double fma =
+            bestSeconds([&] { pool.parallel_for(0, threads, 1, fmaRange); });
+        ret.peakGflops = 2. * kLanes * kFmaIters * threads / fma / 1e9;
+        // Keep the results observable so the loops are not optimised away.
+        volatile float observed = a[n / 2];
+        for (float s : sink)
+            observed = observed + s;
+        return ret;
+    }
+
+} // namespace infini
@@ -3,23 +3,111 @@
 #include "core/kernel.h"
 #include "core/graph.h"
 #include "core/kernel.h"
+#include "core/profiler.h"
 #include <chrono>
 #include <cstring>
 #include <memory>
 namespace infini
 {
+    NativeCpuRuntimeObj::NativeCpuRuntimeObj(const ThreadPoolConfig &config)
+        : RuntimeObj(Device::CPU), threadPool(new ThreadPool(config)),
+          profiler(new Profiler()) {}
+
+    NativeCpuRuntimeObj::~NativeCpuRuntimeObj() {}
+
     void NativeCpuRuntimeObj::run(const Graph &graph) const
     {
+        graph->bindActivations();
+        if (profiling)
+            return runWithProfiler(graph);
         const auto &kernelRegistry = KernelRegistry::getInstance();
 
         for (auto &op : graph->getOperators())
         {
             auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying()};
             Kernel *kernel = kernelRegistry.getKernel(kernelAttrs);
+            ThreadPool::ConcurrencyLimit limit(getNumThreadsFor(op));
             kernel->compute(op, this);
         }
     }
 
+    void NativeCpuRuntimeObj::runWithProfiler(const Graph &graph) const
+    {
+        const auto &kernelRegistry = KernelRegistry::getInstance();
+        int threadId = Profiler::currentThreadId();
+        std::unique_ptr<PerfCounters> counters;
+        if (hardwareCounters)
+        {
+            vector<int> tids{0};
+            for (int tid : threadPool->getThreadIds())
+                tids.emplace_back(tid);
+            counters.reset(new PerfCounters(tids));
+            if (!counters->isAvailable())
+            {
+                profiler->setCounterError(counters->getError());
+                counters.reset();
+            }
+        }
+
+        for (auto &op : graph->getOperators())
+        {
+            auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying()};
+            Kernel *kernel = kernelRegistry.getKernel(kernelAttrs);
+            int numThreads = getNumThreadsFor(op);
+            ThreadPool::ConcurrencyLimit limit(numThreads);
+            CounterValues before;
+            if (counters)
+                before = counters->read();
+            auto start = Profiler::Clock::now();
+            kernel->compute(op, this);
+            auto end = Profiler::Clock::now();
+
+            ProfileRecord record{
+                op->getGuid(),
+                op->getOpType(),
+                std::get<1>(kernelRegistry.getKernelItem(kernelAttrs)),
+                {},
+                op->getDType(),
+                threadId,
+                numThreads,
+                profiler->toUs(start),
+                std::chrono::duration<double, std::micro>(end - start).count(),
+                op->getCost()};
+            if (counters)
+            {
+                record.hasCounters = true;
+                record.counters = counters->read() - before;
+            }
+            for (auto &input : op->getInputs())
+                record.inputShapes.emplace_back(input->getDims());
+            profiler->record(std::move(record));
+        }
+    }
+
+    const Roofline &NativeCpuRuntimeObj::getRoofline() const
+    {
+        std::call_once(rooflineProbed,
+                       [this]
+                       { roofline = probeRoofline(*threadPool); });
+        return roofline;
+    }
+
+    void NativeCpuRuntimeObj::printRooflineReport() const
+    {
+        std::cout << profiler->rooflineReport(getRoofline());
+    }
+
+    int NativeCpuRuntimeObj::getNumThreadsFor(const Operator &op) const
+    {
+        int maxThreads = threadPool->getNumThreads();
+        if (maxThreads == 1)
+            return 1;
+        auto cost = op->getCost();
+        size_t work = cost.flops + cost.bytes;
+        size_t perThread = std::max<size_t>(1, threadPool->getConfig().minWorkPerThread);
+        return (int)std::clamp<size_t>(work / perThread, 1, maxThreads);
+    }
+
     string NativeCpuRuntimeObj::toString() const { return "CPU Runtime"; }
 
     void NativeCpuRuntimeObj::dealloc(void *ptr)
@@ -0,0 +1,26 @@
+#include "core/session.h"
+
+namespace infini
+{
+    SessionObj::SessionObj(const Graph &model)
+        : graph(model->cloneWithSharedWeights())
+    {
+        graph->dataMalloc();
+    }
+
+    TensorVec SessionObj::getInputs() const
+    {
+        TensorVec ret;
+        for (const auto &input : graph->getInputs())
+            if (!input->isConstant())
+                ret.emplace_back(input);
+        return ret;
+    }
+
+    void SessionObj::resize(const TensorVec &inputs, const vector<Shape> &dims)
+    {
+        graph->resize(inputs, dims);
+    }
+
+    void SessionObj::run() { graph->getRuntime()->run(graph); }
+} // namespace infini
@@ -9,7 +9,8 @@ namespace infini {
 
     TensorObj::TensorObj(Shape shape_, DataType dtype, Runtime runtime)
         : dim(shape_.size()), dtype(dtype), runtime(runtime), shape(std::move(shape_)),
-          _size(std::accumulate(shape.begin(), shape.end(), 1, std::multiplies{})) {}
+          _size(std::accumulate(shape.begin(), shape.end(), size_t(1),
+                                std::multiplies{})) {}
 
     string TensorObj::toString() const
     {
@@ -24,8 +25,8 @@ namespace infini {
                      ", dtype " + dtype.toString() + ", " + runtime->toString() +
                      ", " + ss.str() + "\n";
         vector<UidBaseType> targetGuids;
-        for (const auto &op : targets)
-            targetGuids.emplace_back(op.lock()->getGuid());
+        for (auto *op : targets)
+            targetGuids.emplace_back(op->getGuid());
         if (auto o = source.lock())
             ret += ", source " + std::to_string(o->getGuid());
         else
@@ -36,11 +37,21 @@ namespace infini {
 
 void TensorObj::setShape(Shape shape_) {
     shape = shape_;
-    size_t size = std::accumulate(shape.begin(), shape.end(), 1,
-                                  [](auto acc, auto x) { return acc * x; });
+    size_t size = std::accumulate(shape.begin(), shape.end(), size_t(1),
+                                  [](size_t acc, auto x) { return acc * x; });
     _size = size;
 }
 
+Stride TensorObj::getStride() const {
+    Stride stride(shape.size());
+    size_t p = 1;
+    for (size_t i = shape.size(); i > 0; --i) {
+        stride[i - 1] = p;
+        p *= shape[i - 1];
+    }
+    return stride;
+}
+
 void TensorObj::printData() const {
     IT_ASSERT(data != nullptr);
     if (!runtime->isCpu())
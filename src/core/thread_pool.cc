@@ -0,0 +1,272 @@
+#include "core/thread_pool.h"
+#include <cstdlib>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace infini
+{
+    namespace
+    {
+        constexpr uint64_t kWorkerBits = 16;
+        constexpr uint64_t kWorkerMask = (uint64_t(1) << kWorkerBits) - 1;
+        // Chunks handed out per thread, so uneven chunks still balance.
+        constexpr size_t kChunksPerThread = 4;
+
+        // Set while the thread is inside a region, nested regions run inline.
+        thread_local bool insideRegion = false;
+        // Set by ThreadPool::ConcurrencyLimit, 0 means unlimited.
+        thread_local int threadLimit = 0;
+
+        inline void cpuRelax()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+
+        int envInt(const char *name, int fallback)
+        {
+            const char *value = std::getenv(name);
+            return value && *value ? std::atoi(value) : fallback;
+        }
+    } // namespace
+
+    ThreadPoolConfig ThreadPoolConfig::fromEnv()
+    {
+        ThreadPoolConfig config;
+        config.numThreads = envInt("INFINI_NUM_THREADS", config.numThreads);
+        config.spinCount = envInt("INFINI_SPIN_COUNT", config.spinCount);
+        if (const char *work = std::getenv("INFINI_MIN_WORK_PER_THREAD"))
+            config.minWorkPerThread = std::stoull(work);
+        if (const char *cpus = std::getenv("INFINI_CPU_AFFINITY"))
+        {
+            std::stringstream ss(cpus);
+            string item;
+            while (std::getline(ss, item, ','))
+                if (!item.empty())
+                    config.cpuAffinity.emplace_back(std::stoi(item));
+        }
+        return config;
+    }
+
+    ThreadPool::ThreadPool(const ThreadPoolConfig &config_) : config(config_)
+    {
+        numThreads = config.numThreads > 0
+                         ? config.numThreads
+                         : std::max(1u, std::thread::hardware_concurrency());
+        IT_ASSERT(numThreads <= (int)kWorkerMask, "Too many threads");
+        IT_ASSERT(config.spinCount >= 0);
+        workers.reserve(numThreads - 1);
+#ifdef __linux__
+        // Checked before any worker starts, which the pool would have to
+        // join before throwing.
+        for (int cpu : config.cpuAffinity)
+            IT_ASSERT(cpu >= 0 && cpu < CPU_SETSIZE,
+                      "Invalid CPU id " + std::to_string(cpu));
+        workerTids.resize(numThreads - 1);
+#endif
+        try
+        {
+            for (int i = 0; i < numThreads - 1; ++i)
+            {
+                workers.emplace_back(&ThreadPool::workerLoop, this, i);
+                if (config.cpuAffinity.empty())
+                    continue;
+#ifdef __linux__
+                int cpu = config.cpuAffinity[i % config.cpuAffinity.size()];
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpu, &set);
+                int ret = pthread_setaffinity_np(
+                    workers.back().native_handle(), sizeof(set), &set);
+                IT_ASSERT(ret == 0, "Failed to pin worker to CPU " +
+                                        std::to_string(cpu));
+#endif
+            }
+        }
+        catch (...)
+        {
+            joinWorkers();
+            throw;
+        }
+#ifdef __linux__
+        std::unique_lock<std::mutex> lk(tidMutex);
+        tidCv.wait(lk, [this]
+                   { return tidsReported == (int)workerTids.size(); });
+#endif
+    }
+
+    ThreadPool::~ThreadPool() { joinWorkers(); }
+
+    void ThreadPool::joinWorkers()
+    {
+        stop.store(true);
+        {
+            std::lock_guard<std::mutex> lk(wakeMutex);
+        }
+        wakeCv.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    ThreadPool::ConcurrencyLimit::ConcurrencyLimit(int maxThreads)
+        : saved(threadLimit)
+    {
+        IT_ASSERT(maxThreads >= 1);
+        threadLimit = saved > 0 ? std::min(saved, maxThreads) : maxThreads;
+    }
+
+    ThreadPool::ConcurrencyLimit::~ConcurrencyLimit() { threadLimit = saved; }
+
+    int ThreadPool::maxThreads() const
+    {
+        return threadLimit > 0 ? std::min(threadLimit, numThreads) : numThreads;
+    }
+
+    size_t ThreadPool::chunkSize(size_t n) const
+    {
+        size_t parts = maxThreads() * kChunksPerThread;
+        return std::max<size_t>(1, (n + parts - 1) / parts);
+    }
+
+    void ThreadPool::parallel_for(size_t begin, size_t end, size_t grain,
+                                  const RangeFunc &fn)
+    {
+        if (end <= begin)
+            return;
+        size_t n = end - begin;
+        size_t chunk = std::max({chunkSize(n), grain, size_t(1)});
+        size_t nChunks = (n + chunk - 1) / chunk;
+        int threads = (int)std::min<size_t>(maxThreads(), nChunks);
+        if (threads <= 1 || insideRegion)
+        {
+            fn(begin, end);
+            return;
+        }
+        std::unique_lock<std::mutex> region(regionMutex, std::try_to_lock);
+        if (!region.owns_lock())
+        {
+            // Another thread owns the workers; don't queue behind it.
+            fn(begin, end);
+            return;
+        }
+
+        job = &fn;
+        jobBegin = begin;
+        jobEnd = end;
+        jobChunk = chunk;
+        error = nullptr;
+        nextChunk.store(0, std::memory_order_relaxed);
+        pending.store(threads - 1, std::memory_order_relaxed);
+        uint64_t next = ((epoch.load(std::memory_order_relaxed) >> kWorkerBits) +
+                         1)
+                            << kWorkerBits |
+                        uint64_t(threads);
+        epoch.store(next);
+        if (sleepers.load() > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lk(wakeMutex);
+            }
+            wakeCv.notify_all();
+        }
+
+        insideRegion = true;
+        runChunks();
+        insideRegion = false;
+        waitDone();
+        job = nullptr;
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    void ThreadPool::runChunks()
+    {
+        size_t chunks = (jobEnd - jobBegin + jobChunk - 1) / jobChunk;
+        size_t c;
+        while ((c = nextChunk.fetch_add(1, std::memory_order_relaxed)) < chunks)
+        {
+            size_t b = jobBegin + c * jobChunk;
+            try
+            {
+                (*job)(b, std::min(jobEnd, b + jobChunk));
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lk(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+                // Let the other threads drain the remaining chunks quickly.
+                nextChunk.store(chunks, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void ThreadPool::waitDone()
+    {
+        for (int i = 0; i < config.spinCount; ++i)
+        {
+            if (pending.load(std::memory_order_acquire) == 0)
+                return;
+            cpuRelax();
+        }
+        std::unique_lock<std::mutex> lk(doneMutex);
+        doneCv.wait(lk, [this]
+                    { return pending.load(std::memory_order_acquire) == 0; });
+    }
+
+    void ThreadPool::workerLoop(int index)
+    {
+        insideRegion = true;
+#ifdef __linux__
+        {
+            std::lock_guard<std::mutex> lk(tidMutex);
+            workerTids[index] = syscall(SYS_gettid);
+            tidsReported++;
+        }
+        tidCv.notify_one();
+#endif
+        uint64_t seen = 0;
+        while (true)
+        {
+            uint64_t current = epoch.load();
+            for (int i = 0; current == seen && i < config.spinCount &&
+                            !stop.load(std::memory_order_relaxed);
+                 ++i)
+            {
+                cpuRelax();
+                current = epoch.load();
+            }
+            if (current == seen && !stop.load())
+            {
+                std::unique_lock<std::mutex> lk(wakeMutex);
+                sleepers.fetch_add(1);
+                wakeCv.wait(lk, [&]
+                            { return stop.load() || epoch.load() != seen; });
+                sleepers.fetch_sub(1);
+                current = epoch.load();
+            }
+            if (stop.load())
+                return;
+            seen = current;
+            // Worker `index` is thread index + 1 of the region.
+            if (index + 1 >= (int)(current & kWorkerMask))
+                continue;
+            runChunks();
+            if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                {
+                    std::lock_guard<std::mutex> lk(doneMutex);
+                }
+                doneCv.notify_one();
+            }
+        }
+    }
+
+} // namespace infini
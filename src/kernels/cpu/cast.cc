@@ -0,0 +1,62 @@
+#include "operators/unary.h"
+#include "core/kernel.h"
+
+namespace infini
+{
+    class NaiveCast : public CpuKernelWithoutConfig
+    {
+        template <typename From, typename To>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            auto op = as<CastObj>(_op);
+            From *inptr = op->getInputs(0)->getRawDataPtr<From *>();
+            To *outptr = op->getOutput()->getRawDataPtr<To *>();
+            auto n = op->getOutput()->size();
+            getThreadPool(context).parallel_for(
+                0, n, kElementGrain, [&](size_t begin, size_t end)
+                {
+                    for (size_t offset = begin; offset < end; offset++)
+                        outptr[offset] = static_cast<To>(inptr[offset]); });
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+#define CASE(TYPE, FROM, TO)        \
+    case CastType::TYPE:            \
+        doCompute<FROM, TO>(_op, context); \
+        break
+
+            // Half precision types have no native C++ type here.
+            switch (as<CastObj>(_op)->getType())
+            {
+                CASE(Float2Int64, float, int64_t);
+                CASE(Float2Int32, float, int32_t);
+                CASE(Float2Int16, float, int16_t);
+                CASE(Float2Int8, float, int8_t);
+                CASE(Int322Float, int32_t, float);
+                CASE(Int322Int8, int32_t, int8_t);
+                CASE(Int322Int16, int32_t, int16_t);
+                CASE(Int322Int64, int32_t, int64_t);
+                CASE(Int162Float, int16_t, float);
+                CASE(Int162Int32, int16_t, int32_t);
+                CASE(Int82Float, int8_t, float);
+                CASE(Int82Int16, int8_t, int16_t);
+                CASE(Int82Int32, int8_t, int32_t);
+                CASE(Uint82Float, uint8_t, float);
+                CASE(Uint82Int32, uint8_t, int32_t);
+                CASE(Uint82Int64, uint8_t, int64_t);
+                CASE(Int642Int32, int64_t, int32_t);
+                CASE(Int642Uint32, int64_t, uint32_t);
+                CASE(Int642Float, int64_t, float);
+                CASE(Uint322Int64, uint32_t, int64_t);
+                CASE(Float2Float, float, float);
+            default:
+                IT_TODO_HALT();
+            }
+#undef CASE
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::Cast, NaiveCast, "CastNaive_CPU");
+}; // namespace infini
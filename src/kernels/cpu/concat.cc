@@ -20,7 +20,7 @@ class NaiveConcat : public CpuKernelWithoutConfig {
         size_t blockOffset = outDim[dim] * blockOffsetInner;
         for (size_t i = 0; i < inputs.size(); ++i) {
             auto input = inputs[i];
-            auto dimOffset = 0;
+            size_t dimOffset = 0;
             auto iDim = iDims[i];
             for (size_t j = 0; j < i; ++j)
                 dimOffset += iDims[j][dim];
@@ -32,12 +32,14 @@ class NaiveConcat : public CpuKernelWithoutConfig {
             auto inSize = input->size();
             auto inPtr = input->getRawDataPtr<T *>(),
                  outPtr = output->getRawDataPtr<T *>();
-#pragma omp parallel for
-            for (size_t iOffset = 0; iOffset < inSize; ++iOffset) {
-                auto oOffset = iOffset % localBlockOffset + innerOffset +
-                               iOffset / localBlockOffset * blockOffset;
-                outPtr[oOffset] = inPtr[iOffset];
-            }
+            getThreadPool(context).parallel_for(
+                0, inSize, kElementGrain, [&](size_t begin, size_t end) {
+                    for (size_t iOffset = begin; iOffset < end; ++iOffset) {
+                        auto oOffset = iOffset % localBlockOffset + innerOffset +
+                                       iOffset / localBlockOffset * blockOffset;
+                        outPtr[oOffset] = inPtr[iOffset];
+                    }
+                });
         }
     }
 
@@ -50,8 +50,8 @@ namespace infini
                       b.begin() + (rank - shapeB.size()));
             auto getStride = [&](const Shape &shape)
             {
-                int p = 1;
-                Shape stride(rank);
+                size_t p = 1;
+                Stride stride(rank);
                 for (auto i = rank; i > 0; --i)
                 {
                     stride[i - 1] = p;
@@ -59,8 +59,8 @@ namespace infini
                 }
                 return stride;
             };
-            Shape strideA = getStride(a);
-            Shape strideB = getStride(b);
+            Stride strideA = getStride(a);
+            Stride strideB = getStride(b);
 
             auto n = op->getOutput()->size();
             T (*_doCompute)
@@ -83,13 +83,16 @@ namespace infini
                 IT_TODO_HALT();
             }
 
-            for (size_t i = 0; i < n; ++i)
-            {
-                auto shapeIndexC = locate_index(i, shapeC);
-                auto indexA = delocate_index(shapeIndexC, a, strideA);
-                auto indexB = delocate_index(shapeIndexC, b, strideB);
-                outptr[i] = _doCompute(inptr0[indexA], inptr1[indexB]);
-            }
+            getThreadPool(context).parallel_for(
+                0, n, kElementGrain, [&](size_t begin, size_t end)
+                {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        auto shapeIndexC = locate_index(i, shapeC);
+                        auto indexA = delocate_index(shapeIndexC, a, strideA);
+                        auto indexB = delocate_index(shapeIndexC, b, strideB);
+                        outptr[i] = _doCompute(inptr0[indexA], inptr1[indexB]);
+                    } });
         }
 
         void compute(const Operator &_op,
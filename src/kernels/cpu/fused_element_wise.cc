@@ -0,0 +1,55 @@
+#include "operators/fused_element_wise.h"
+#include "core/kernel.h"
+#include "fused_steps.h"
+
+namespace infini
+{
+    class NativeFusedElementWise : public CpuKernelWithoutConfig
+    {
+        // T is the type computed in, Out the type of the output.
+        template <typename T, typename Out>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            auto op = as<FusedElementWiseObj>(_op);
+            const auto &steps = op->getSteps();
+            Out *outptr = op->getOutput()->getRawDataPtr<Out *>();
+            FusedInputs<T> inputs(op->getInputs(), op->getOutput()->getDims());
+            size_t numValues = inputs.size() + steps.size();
+
+            getThreadPool(context).parallel_for(
+                0, op->getOutput()->size(), kElementGrain,
+                [&](size_t begin, size_t end)
+                {
+                    // One block per value: loaded inputs, then the steps.
+                    vector<T> scratch(numValues * kFusedBlock);
+                    vector<const T *> values(numValues);
+                    vector<size_t> offsets;
+                    for (size_t base = begin; base < end; base += kFusedBlock)
+                    {
+                        size_t len = std::min(kFusedBlock, end - base);
+                        inputs.load(base, len, scratch.data(), values.data(),
+                                    offsets);
+                        const T *last = evalFusedSteps(
+                            steps, values.data(), inputs.size(),
+                            scratch.data() + inputs.size() * kFusedBlock, len);
+                        for (size_t j = 0; j < len; ++j)
+                            outptr[base + j] = static_cast<Out>(last[j]);
+                    }
+                });
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            dispatchFusedTypes(_op->getDType(), _op->getOutDType(),
+                               [&](auto t, auto out)
+                               {
+                                   doCompute<decltype(t), decltype(out)>(
+                                       _op, context);
+                               });
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::FusedElementWise,
+                    NativeFusedElementWise, "FusedElementWise_CPU");
+}; // namespace infini
@@ -0,0 +1,210 @@
+#pragma once
+#include "operators/fused_element_wise.h"
+#include "utils/operator_utils.h"
+
+// Evaluation of FusedStep programs, shared by the fused element-wise kernel
+// and the MatMul epilogue.
+namespace infini
+{
+    // Elements a step is applied to before the next step runs. The
+    // intermediates of one block stay in L1 and the per-step loops are simple
+    // enough to vectorise.
+    constexpr size_t kFusedBlock = 256;
+
+    /**
+     * @brief Reads of region inputs by output element index, with inputs
+     * broadcast to the output shape.
+     */
+    template <typename T>
+    class FusedInputs
+    {
+    public:
+        FusedInputs(const TensorVec &tensors, const Shape &shapeC)
+            : shapeC(shapeC)
+        {
+            auto rank = shapeC.size();
+            for (auto &tensor : tensors)
+            {
+                auto dims = tensor->getDims();
+                Source src{tensor->getRawDataPtr<T *>(), Access::Gather,
+                           Stride(rank, 0)};
+                if (dims == shapeC)
+                    src.access = Access::Dense;
+                else if (tensor->size() == 1)
+                    src.access = Access::Scalar;
+                else
+                    gathered.emplace_back(sources.size());
+                size_t p = 1;
+                for (size_t i = dims.size(), d = rank; i > 0; --i, --d)
+                {
+                    if (dims[i - 1] != 1)
+                        src.stride[d - 1] = p;
+                    p *= dims[i - 1];
+                }
+                sources.emplace_back(std::move(src));
+            }
+        }
+
+        size_t size() const { return sources.size(); }
+
+        /**
+         * @brief Points values[i] at elements [base, base + len) of input i.
+         * Inputs of the output's shape are read in place; the others are
+         * copied to block i of `scratch`. `offsets` is per-thread workspace.
+         */
+        void load(size_t base, size_t len, T *scratch, const T **values,
+                  vector<size_t> &offsets) const
+        {
+            for (size_t i = 0; i < sources.size(); ++i)
+            {
+                T *block = scratch + i * kFusedBlock;
+                switch (sources[i].access)
+                {
+                case Access::Dense:
+                    values[i] = sources[i].ptr + base;
+                    continue;
+                case Access::Scalar:
+                    std::fill_n(block, len, *sources[i].ptr);
+                    break;
+                case Access::Gather:
+                    break;
+                }
+                values[i] = block;
+            }
+            if (gathered.empty())
+                return;
+            // The output index advances like an odometer, so each element
+            // costs a few additions.
+            auto rank = shapeC.size();
+            auto index = locate_index(base, shapeC);
+            offsets.resize(gathered.size());
+            for (size_t g = 0; g < gathered.size(); ++g)
+            {
+                offsets[g] = 0;
+                for (size_t d = 0; d < rank; ++d)
+                    offsets[g] += index[d] * sources[gathered[g]].stride[d];
+            }
+            for (size_t j = 0; j < len; ++j)
+            {
+                for (size_t g = 0; g < gathered.size(); ++g)
+                    scratch[gathered[g] * kFusedBlock + j] =
+                        sources[gathered[g]].ptr[offsets[g]];
+                for (size_t d = rank; d > 0; --d)
+                {
+                    for (size_t g = 0; g < gathered.size(); ++g)
+                        offsets[g] += sources[gathered[g]].stride[d - 1];
+                    if (++index[d - 1] < shapeC[d - 1])
+                        break;
+                    for (size_t g = 0; g < gathered.size(); ++g)
+                        offsets[g] -= sources[gathered[g]].stride[d - 1] *
+                                      shapeC[d - 1];
+                    index[d - 1] = 0;
+                }
+            }
+        }
+
+    private:
+        enum class Access
+        {
+            Dense,
+            Scalar,
+            Gather
+        };
+        struct Source
+        {
+            const T *ptr;
+            Access access;
+            // Input offset step per output dim, 0 along broadcast dims.
+            Stride stride;
+        };
+        Shape shapeC;
+        vector<Source> sources;
+        vector<size_t> gathered;
+    };
+
+    template <typename T>
+    void evalFusedStep(const FusedStep &step, const T *const *values, T *res,
+                       size_t len)
+    {
+        const T *a = values[step.args[0]];
+        const T *b = step.args[1] < 0 ? nullptr : values[step.args[1]];
+        switch (step.type.underlying())
+        {
+        case OpType::Add:
+            for (size_t j = 0; j < len; ++j)
+                res[j] = a[j] + b[j];
+            break;
+        case OpType::Sub:
+            for (size_t j = 0; j < len; ++j)
+                res[j] = a[j] - b[j];
+            break;
+        case OpType::Mul:
+            for (size_t j = 0; j < len; ++j)
+                res[j] = a[j] * b[j];
+            break;
+        case OpType::Div:
+            for (size_t j = 0; j < len; ++j)
+                res[j] = (T)(a[j] / b[j]);
+            break;
+        case OpType::Relu:
+            for (size_t j = 0; j < len; ++j)
+                res[j] = std::max(T(0), a[j]);
+            break;
+        case OpType::Clip:
+            for (size_t j = 0; j < len; ++j)
+                res[j] = (step.min && a[j] < *step.min)   ? T(*step.min)
+                         : (step.max && a[j] > *step.max) ? T(*step.max)
+                                                          : a[j];
+            break;
+        case OpType::Cast:
+            // Converted when the result is stored.
+            std::copy(a, a + len, res);
+            break;
+        default:
+            IT_TODO_HALT();
+        }
+    }
+
+    /**
+     * @brief Runs `steps` on one block of at most kFusedBlock elements whose
+     * inputs are values[0, numInputs). Step k writes block k of `scratch`.
+     * Returns the result of the last step.
+     */
+    template <typename T>
+    const T *evalFusedSteps(const vector<FusedStep> &steps, const T **values,
+                            size_t numInputs, T *scratch, size_t len)
+    {
+        for (size_t k = 0; k < steps.size(); ++k)
+        {
+            T *res = scratch + k * kFusedBlock;
+            evalFusedStep(steps[k], values, res, len);
+            values[numInputs + k] = res;
+        }
+        return values[numInputs + steps.size() - 1];
+    }
+
+    /**
+     * @brief Calls fn(T(), Out()) with the C++ types of a region computing
+     * in `in` and storing `out`.
+     */
+    template <typename Fn>
+    void dispatchFusedTypes(DataType in, DataType out, Fn &&fn)
+    {
+        if (in == DataType::UInt32 && out == DataType::UInt32)
+            fn(uint32_t(), uint32_t());
+        else if (in != DataType::Float32)
+            IT_TODO_HALT();
+        else if (out == DataType::Float32)
+            fn(float(), float());
+        else if (out == DataType::Int64)
+            fn(float(), int64_t());
+        else if (out == DataType::Int32)
+            fn(float(), int32_t());
+        else if (out == DataType::Int16)
+            fn(float(), int16_t());
+        else if (out == DataType::Int8)
+            fn(float(), int8_t());
+        else
+            IT_TODO_HALT();
+    }
+} // namespace infini
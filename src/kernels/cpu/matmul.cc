@@ -0,0 +1,232 @@
+#include "operators/matmul.h"
+#include "core/kernel.h"
+#include "fused_steps.h"
+#include "utils/operator_utils.h"
+
+namespace infini
+{
+    class NaiveMatmul : public CpuKernelWithoutConfig
+    {
+        // Columns of a packed panel of B: a row of it spans 4 cache lines
+        // and a 1024-deep panel fits in L2.
+        static constexpr size_t kPanel = 64;
+
+        // Element offsets of every broadcast batch of `shape` (a tensor of
+        // rank >= 2) in the batch order of `batchC`.
+        static vector<size_t> batchOffsets(const Shape &shape,
+                                           const Shape &batchC)
+        {
+            size_t rank = batchC.size();
+            size_t matSize = size_t(shape[shape.size() - 1]) *
+                             shape[shape.size() - 2];
+            Shape batch(rank, 1);
+            std::copy(shape.begin(), shape.end() - 2,
+                      batch.end() - (shape.size() - 2));
+            Stride stride(rank, 1);
+            for (size_t i = rank; i > 1; --i)
+                stride[i - 2] = stride[i - 1] * batch[i - 1];
+            size_t nBatch = std::accumulate(batchC.begin(), batchC.end(),
+                                            size_t(1), std::multiplies{});
+            vector<size_t> ret(nBatch);
+            for (size_t b = 0; b < nBatch; ++b)
+                ret[b] = delocate_index(locate_index(b, batchC), batch, stride) *
+                         matSize;
+            return ret;
+        }
+
+        // c[0, w) = a . p for a row a of A (elements aStride apart) and a
+        // packed K x w panel p. A full panel has its width known at compile
+        // time, which keeps the sums in registers.
+        template <typename T, size_t W = 0>
+        static void panelRow(T *c, const T *a, size_t aStride, const T *p,
+                             size_t K, size_t w = W)
+        {
+            T sum[W ? W : kPanel] = {};
+            for (size_t kk = 0; kk < K; ++kk, p += w)
+            {
+                T aVal = a[kk * aStride];
+                for (size_t j = 0; j < (W ? W : w); ++j)
+                    sum[j] += aVal * p[j];
+            }
+            std::copy(sum, sum + w, c);
+        }
+
+        // T is the type computed in, Out the type of C, which differs only
+        // if the epilogue ends with a Cast.
+        template <typename T, typename Out>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            auto op = as<MatmulObj>(_op);
+            IT_ASSERT(op->getInputs(0)->getRank() >= 2 &&
+                      op->getInputs(1)->getRank() >= 2);
+            T *A = op->getInputs(0)->getRawDataPtr<T *>();
+            T *B = op->getInputs(1)->getRawDataPtr<T *>();
+            Out *C = op->getOutput()->getRawDataPtr<Out *>();
+            const size_t M = op->getM(), N = op->getN(), K = op->getK();
+            const bool transA = op->getTransA(), transB = op->getTransB();
+
+            auto shapeC = op->getOutput()->getDims();
+            Shape batchC(shapeC.begin(), shapeC.end() - 2);
+            auto offA = batchOffsets(op->getInputs(0)->getDims(), batchC);
+            auto offB = batchOffsets(op->getInputs(1)->getDims(), batchC);
+
+            const auto &epilogue = op->getEpilogue();
+            FusedInputs<T> extra(
+                TensorVec(op->getInputs().begin() + 2, op->getInputs().end()),
+                shapeC);
+            size_t numValues = 1 + extra.size() + epilogue.size();
+            const size_t panel = op->getPackedB();
+
+            // One task per output row of every batch.
+            getThreadPool(context).parallel_for(
+                0, offA.size() * M, std::max<size_t>(1, 4096 / (N * K + 1)),
+                [&](size_t begin, size_t end)
+                {
+                    // With an epilogue, a row (or a panel of it) is
+                    // accumulated here and finished while it is in cache.
+                    vector<T> acc, scratch;
+                    vector<const T *> values;
+                    vector<size_t> offsets;
+                    if (!epilogue.empty())
+                    {
+                        acc.resize(panel ? panel : N);
+                        scratch.resize((numValues - 1) * kFusedBlock);
+                        values.resize(numValues);
+                    }
+                    // Where the product of `row` from column j0 on is
+                    // accumulated.
+                    auto target = [&](size_t row, size_t j0)
+                    {
+                        if constexpr (std::is_same_v<T, Out>)
+                            if (epilogue.empty())
+                                return C + row * N + j0;
+                        return acc.data();
+                    };
+                    // Applies the epilogue to c[0, len), the product at
+                    // columns [j0, j0 + len) of `row`, and stores it.
+                    auto finish = [&](const T *c, size_t row, size_t j0,
+                                      size_t len)
+                    {
+                        for (size_t jb = 0; jb < len; jb += kFusedBlock)
+                        {
+                            size_t n = std::min(kFusedBlock, len - jb);
+                            values[0] = c + jb;
+                            extra.load(row * N + j0 + jb, n, scratch.data(),
+                                       values.data() + 1, offsets);
+                            const T *last = evalFusedSteps(
+                                epilogue, values.data(), 1 + extra.size(),
+                                scratch.data() + extra.size() * kFusedBlock,
+                                n);
+                            Out *out = C + row * N + j0 + jb;
+                            for (size_t j = 0; j < n; ++j)
+                                out[j] = static_cast<Out>(last[j]);
+                        }
+                    };
+
+                    if (panel)
+                    {
+                        // Panels outermost, so that each K x panel block of
+                        // B is reused from cache by all rows of the task.
+                        for (size_t j0 = 0; j0 < N; j0 += panel)
+                        {
+                            size_t w = std::min(panel, N - j0);
+                            for (size_t row = begin; row < end; ++row)
+                            {
+                                size_t b = row / M, i = row % M;
+                                const T *a =
+                                    A + offA[b] + (transA ? i : i * K);
+                                size_t aStride = transA ? M : 1;
+                                const T *p = B + offB[b] + j0 * K;
+                                T *c = target(row, j0);
+                                if (w == kPanel)
+                                    panelRow<T, kPanel>(c, a, aStride, p, K);
+                                else
+                                    panelRow<T>(c, a, aStride, p, K, w);
+                                if (!epilogue.empty())
+                                    finish(c, row, j0, w);
+                            }
+                        }
+                        return;
+                    }
+
+                    for (size_t row = begin; row < end; ++row)
+                    {
+                        size_t b = row / M, i = row % M;
+                        const T *a = A + offA[b];
+                        const T *bMat = B + offB[b];
+                        T *c = target(row, 0);
+                        std::fill(c, c + N, T(0));
+                        for (size_t kk = 0; kk < K; ++kk)
+                        {
+                            T aVal = transA ? a[kk * M + i] : a[i * K + kk];
+                            if (transB)
+                                for (size_t j = 0; j < N; ++j)
+                                    c[j] += aVal * bMat[j * K + kk];
+                            else
+                            {
+                                const T *bRow = bMat + kk * N;
+                                for (size_t j = 0; j < N; ++j)
+                                    c[j] += aVal * bRow[j];
+                            }
+                        }
+                        if (!epilogue.empty())
+                            finish(c, row, 0, N);
+                    }
+                });
+        }
+
+        // Rewrites every K x N matrix of B as column panels of width
+        // kPanel, the last one narrower: panel j0 holds element (k, j) at
+        // j0 * K + k * width + (j - j0).
+        template <typename T>
+        static void packB(const MatmulObj &op)
+        {
+            const auto &B = op.getInputs(1);
+            T *data = B->getRawDataPtr<T *>();
+            const size_t N = op.getN(), K = op.getK();
+            const bool transB = op.getTransB();
+            vector<T> mat(N * K);
+            for (size_t off = 0; off < B->size(); off += N * K)
+            {
+                std::copy(data + off, data + off + N * K, mat.begin());
+                T *p = data + off;
+                for (size_t j0 = 0; j0 < N; j0 += kPanel)
+                {
+                    size_t w = std::min(kPanel, N - j0);
+                    for (size_t kk = 0; kk < K; ++kk)
+                        for (size_t j = j0; j < j0 + w; ++j)
+                            *p++ = transB ? mat[j * K + kk] : mat[kk * N + j];
+                }
+            }
+        }
+
+    public:
+        bool packConstants(const Operator &_op,
+                           const RuntimeObj *context) const override
+        {
+            auto op = as<MatmulObj>(_op);
+            const auto &B = op->getInputs(1);
+            // Other readers expect B in its own layout.
+            if (op->getPackedB() || !B->isConstant() ||
+                B->getTargetList().size() != 1 ||
+                B->getDType().getSize() != sizeof(uint32_t))
+                return false;
+            packB<uint32_t>(*op);
+            op->setPackedB(kPanel);
+            return true;
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            dispatchFusedTypes(_op->getDType(), _op->getOutDType(),
+                               [&](auto t, auto out)
+                               {
+                                   doCompute<decltype(t), decltype(out)>(
+                                       _op, context);
+                               });
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::MatMul, NaiveMatmul, "MatmulNaive_CPU");
+}; // namespace infini
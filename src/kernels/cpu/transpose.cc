@@ -25,15 +25,17 @@ class NaiveTranspose : public CpuKernelWithoutConfig {
         size_t inSize = inputs[0]->size();
         auto inPtr = inputs[0]->getRawDataPtr<T *>(),
              outPtr = outputs[0]->getRawDataPtr<T *>();
-        // #pragma omp parallel for
-        for (size_t inIdx = 0; inIdx < inSize; ++inIdx) {
-            auto posInput = idx2Pos(inDim, inIdx);
-            int outIdx = 0;
-            for (size_t j = 0, jEnd = perm.size(); j < jEnd; ++j) {
-                outIdx = outIdx * inDim[perm[j]] + posInput[perm[j]];
-            }
-            outPtr[outIdx] = inPtr[inIdx];
-        }
+        getThreadPool(context).parallel_for(
+            0, inSize, kElementGrain, [&](size_t begin, size_t end) {
+                for (size_t inIdx = begin; inIdx < end; ++inIdx) {
+                    auto posInput = idx2Pos(inDim, inIdx);
+                    size_t outIdx = 0;
+                    for (size_t j = 0, jEnd = perm.size(); j < jEnd; ++j) {
+                        outIdx = outIdx * inDim[perm[j]] + posInput[perm[j]];
+                    }
+                    outPtr[outIdx] = inPtr[inIdx];
+                }
+            });
     }
 
     void compute(const Operator &_op,
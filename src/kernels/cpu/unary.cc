@@ -18,7 +18,6 @@ namespace infini
             T *inptr = op->getInputs(0)->getRawDataPtr<T *>();
             T *outptr = op->getOutput()->getRawDataPtr<T *>();
 
-            auto outDim = op->getOutput()->getDims();
             auto n = op->getOutput()->size();
 
             T (*_doCompute)
@@ -32,10 +31,13 @@ namespace infini
                 IT_TODO_HALT();
             }
 
-            for (size_t offset = 0; offset < n; offset++)
-            {
-                outptr[offset] = _doCompute(inptr[offset]);
-            }
+            getThreadPool(context).parallel_for(
+                0, n, kElementGrain, [&](size_t begin, size_t end)
+                {
+                    for (size_t offset = begin; offset < end; offset++)
+                    {
+                        outptr[offset] = _doCompute(inptr[offset]);
+                    } });
         }
 
         void compute(const Operator &_op,
@@ -70,13 +72,16 @@ namespace infini
             auto maxValue = op->getMax();
 
             auto n = op->getOutput()->size();
-            for (size_t offset = 0; offset < n; offset++)
-            {
-                auto val = *inptr++;
-                *outptr++ = (minValue && val < *minValue)   ? *minValue
-                            : (maxValue && val > *maxValue) ? *maxValue
-                                                            : val;
-            }
+            getThreadPool(context).parallel_for(
+                0, n, kElementGrain, [&](size_t begin, size_t end)
+                {
+                    for (size_t offset = begin; offset < end; offset++)
+                    {
+                        auto val = inptr[offset];
+                        outptr[offset] = (minValue && val < *minValue)   ? *minValue
+                                         : (maxValue && val > *maxValue) ? *maxValue
+                                                                         : val;
+                    } });
         }
 
         void compute(const Operator &_op,
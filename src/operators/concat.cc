@@ -43,12 +43,26 @@ optional<vector<Shape>> ConcatObj::inferShape(const TensorVec &inputs) {
         concatDimTotal += tensor->getDims()[static_cast<size_t>(dim)];
     }
     // 更新拼接维度大小（确保类型匹配 Shape 元素类型 int）
-    dims[dim] = static_cast<int>(concatDimTotal);
+    IT_ASSERT(concatDimTotal <=
+                  size_t(std::numeric_limits<ShapeElem>::max()),
+              "Concat dimension overflows ShapeElem");
+    dims[dim] = static_cast<ShapeElem>(concatDimTotal);
     // =================================== 作业实现 ===================================
 
     return {{dims}};
 }
 
+vector<int> ConcatObj::getOpAttrVector() const {
+    return {type.underlying(), dim};
+}
+
+OpCost ConcatObj::getCost() const {
+    // Pure data movement.
+    OpCost cost = OperatorObj::getCost();
+    cost.flops = 0;
+    return cost;
+}
+
 std::string ConcatObj::toString() const {
     std::ostringstream os;
     os << "Concat[" << getGuid() << "]";
@@ -0,0 +1,107 @@
+#include "operators/fused_element_wise.h"
+#include "utils/operator_utils.h"
+
+namespace infini
+{
+    void checkFusedSteps(size_t numInputs, const vector<FusedStep> &steps)
+    {
+        int numValues = numInputs;
+        for (auto &step : steps)
+        {
+            bool binary =
+                step.type == OpType::Add || step.type == OpType::Sub ||
+                step.type == OpType::Mul || step.type == OpType::Div;
+            for (int i = 0; i < 2; ++i)
+            {
+                bool defined = step.args[i] >= 0 && step.args[i] < numValues;
+                IT_ASSERT(i == 0 || binary ? defined : step.args[i] == -1,
+                          "Fused step reads an undefined value");
+            }
+            IT_ASSERT(step.type != OpType::Cast || &step == &steps.back(),
+                      "Only the last fused step may be a Cast");
+            ++numValues;
+        }
+    }
+
+    Shape inferFusedShape(vector<Shape> values, const vector<FusedStep> &steps)
+    {
+        values.reserve(values.size() + steps.size());
+        for (auto &step : steps)
+        {
+            const Shape &a = values[step.args[0]];
+            values.emplace_back(step.args[1] < 0
+                                    ? a
+                                    : infer_broadcast(a, values[step.args[1]]));
+        }
+        return values.back();
+    }
+
+    void appendFusedSteps(vector<int> &attrs, const vector<FusedStep> &steps)
+    {
+        for (auto &step : steps)
+        {
+            attrs.insert(attrs.end(), {step.type.underlying(), step.args[0],
+                                       step.args[1], step.dtype.getIndex()});
+            append_attr(attrs, step.min);
+            append_attr(attrs, step.max);
+        }
+    }
+
+    FusedElementWiseObj::FusedElementWiseObj(GraphObj *graph, TensorVec inputs,
+                                             Tensor output,
+                                             vector<FusedStep> steps)
+        : OperatorObj(OpType::FusedElementWise, inputs, {output}),
+          steps(std::move(steps))
+    {
+        IT_ASSERT(!this->inputs.empty() && !this->steps.empty());
+        checkFusedSteps(this->inputs.size(), this->steps);
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> FusedElementWiseObj::inferShape(
+        const TensorVec &inputs)
+    {
+        vector<Shape> shapes;
+        for (auto &input : inputs)
+            shapes.emplace_back(input->getDims());
+        return {{inferFusedShape(std::move(shapes), steps)}};
+    }
+
+    vector<DataType>
+    FusedElementWiseObj::inferDataType(const TensorVec &inputs) const
+    {
+        return {steps.back().dtype};
+    }
+
+    OpCost FusedElementWiseObj::getCost() const
+    {
+        // Inputs and the output cross memory once, whatever the step count.
+        OpCost cost = OperatorObj::getCost();
+        cost.flops *= steps.size();
+        return cost;
+    }
+
+    vector<int> FusedElementWiseObj::getOpAttrVector() const
+    {
+        vector<int> ret{type.underlying()};
+        appendFusedSteps(ret, steps);
+        return ret;
+    }
+
+    std::string FusedElementWiseObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(outputs[0]->getDims()) << ",";
+        os << "steps=[";
+        for (size_t i = 0; i < steps.size(); ++i)
+            os << (i ? "," : "") << steps[i].type.toString();
+        os << "],";
+        os << "input=";
+        for (auto &input : inputs)
+            os << input->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+} // namespace infini
@@ -3,10 +3,15 @@
 namespace infini
 {
     MatmulObj::MatmulObj(GraphObj *graph, Tensor A, Tensor B, Tensor C, bool transA,
-                         bool transB)
+                         bool transB, TensorVec epilogueInputs,
+                         vector<FusedStep> epilogue)
         : OperatorObj(OpType::MatMul, TensorVec{A, B}, {C}),
-          transA(transA), transB(transB)
+          transA(transA), transB(transB), epilogue(std::move(epilogue))
     {
+        inputs.insert(inputs.end(), epilogueInputs.begin(),
+                      epilogueInputs.end());
+        IT_ASSERT(!this->epilogue.empty() || epilogueInputs.empty());
+        checkFusedSteps(1 + epilogueInputs.size(), this->epilogue);
         IT_ASSERT(checkValid(graph));
     }
 
@@ -16,14 +21,41 @@ namespace infini
         os << "Matmul([" << (transA ? "A^T" : "A") << "," << (transB ? "B^T" : "B")
            << "],A=" << inputs[0]->getGuid()
            << ",B=" << inputs[1]->getGuid() << ",C=" << outputs[0]->getGuid()
-           << ",mnk=[" << m << "," << n << "," << k << "])";
+           << ",mnk=[" << m << "," << n << "," << k << "]";
+        if (packedB)
+            os << ",packedB=" << packedB;
+        if (!epilogue.empty())
+        {
+            os << ",epilogue=[";
+            for (size_t i = 0; i < epilogue.size(); ++i)
+                os << (i ? "," : "") << epilogue[i].type.toString();
+            os << "]";
+        }
+        os << ")";
         return os.str();
     }
 
+    vector<int> MatmulObj::getOpAttrVector() const
+    {
+        vector<int> ret{type.underlying(), transA, transB, packedB};
+        appendFusedSteps(ret, epilogue);
+        return ret;
+    }
+
+    OpCost MatmulObj::getCost() const
+    {
+        OpCost cost = OperatorObj::getCost();
+        // One multiply and one add per (m, n, k) point of every batch.
+        size_t batch = outputs[0]->size() / std::max<size_t>(1, size_t(m) * n);
+        cost.flops = 2 * batch * m * n * k;
+        cost.flops += outputs[0]->size() * epilogue.size();
+        return cost;
+    }
+
     optional<vector<Shape>> MatmulObj::inferShape(const TensorVec &inputs)
     {
         // =================================== 作业实现 ===================================
-        IT_ASSERT(inputs.size() == 2, "Matmul 仅支持两个输入张量");
+        IT_ASSERT(inputs.size() >= 2, "Matmul 至少需要两个输入张量");
         const auto A = inputs[0];
         const auto B = inputs[1];
         auto shapeA = A->getDims();
@@ -64,7 +96,23 @@ namespace infini
         n = matB_N;
         k = matA_K;
 
+        if (!epilogue.empty())
+        {
+            vector<Shape> values{outputShape};
+            for (size_t i = 2; i < inputs.size(); ++i)
+                values.emplace_back(inputs[i]->getDims());
+            // The epilogue must not broadcast the product to a larger shape.
+            if (inferFusedShape(std::move(values), epilogue) != outputShape)
+                return {};
+        }
         return {{outputShape}};
         // =================================== 作业实现 ===================================
     }
+
+    vector<DataType> MatmulObj::inferDataType(const TensorVec &inputs) const
+    {
+        if (epilogue.empty())
+            return OperatorObj::inferDataType(inputs);
+        return {epilogue.back().dtype};
+    }
 } // namespace infini
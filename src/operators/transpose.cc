@@ -23,6 +23,13 @@ namespace infini
         IT_ASSERT(checkValid(graph));
     }
 
+    void TransposeObj::setPermute(vector<int> permute)
+    {
+        IT_ASSERT(permute.size() == transposePermute.size());
+        transposePermute = std::move(permute);
+        IT_ASSERT(checkValid(nullptr), "Permutation changes the output shape");
+    }
+
     optional<vector<Shape>> TransposeObj::inferShape(const TensorVec &inputs)
     {
         const auto A = inputs[0];
@@ -48,6 +55,21 @@ namespace infini
         return {{output_dim}}; // 返回推导后的输出形状（vector<Shape> 格式）
     }
 
+    OpCost TransposeObj::getCost() const
+    {
+        // Pure data movement.
+        OpCost cost = OperatorObj::getCost();
+        cost.flops = 0;
+        return cost;
+    }
+
+    vector<int> TransposeObj::getOpAttrVector() const
+    {
+        vector<int> ret{type.underlying()};
+        ret.insert(ret.end(), transposePermute.begin(), transposePermute.end());
+        return ret;
+    }
+
     std::string TransposeObj::toString() const
     {
         std::ostringstream os;
@@ -1,4 +1,5 @@
 #include "operators/unary.h"
+#include "utils/operator_utils.h"
 
 namespace infini
 {
@@ -43,6 +44,23 @@ namespace infini
         // =================================== 作业实现 ===================================
     }
 
+    OpCost ClipObj::getCost() const
+    {
+        // One comparison per element and bound.
+        OpCost cost = OperatorObj::getCost();
+        cost.flops = outputs[0]->size() *
+                     (minValue.has_value() + maxValue.has_value());
+        return cost;
+    }
+
+    vector<int> ClipObj::getOpAttrVector() const
+    {
+        vector<int> ret{type.underlying()};
+        append_attr(ret, minValue);
+        append_attr(ret, maxValue);
+        return ret;
+    }
+
     std::string ClipObj::toString() const
     {
         std::ostringstream os;
@@ -85,6 +103,11 @@ namespace infini
         // =================================== 作业实现 ===================================
     }
 
+    vector<int> CastObj::getOpAttrVector() const
+    {
+        return {type.underlying(), int(castType)};
+    }
+
     std::string CastObj::toString() const
     {
         std::ostringstream os;
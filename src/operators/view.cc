@@ -0,0 +1,56 @@
+#include "operators/view.h"
+#include <numeric>
+
+namespace infini
+{
+    ViewObj::ViewObj(GraphObj *graph, Tensor input, Tensor output,
+                     Shape shape, size_t index)
+        : OperatorObj(OpType::View, {input}, {output}),
+          shape(std::move(shape)), index(index)
+    {
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> ViewObj::inferShape(const TensorVec &inputs)
+    {
+        const auto &dims = inputs[0]->getDims();
+        Shape ret = shape;
+        for (size_t i = ret.size(), j = dims.size(); i > 0; --i, --j)
+        {
+            if (ret[i - 1] != 0)
+                continue;
+            if (j == 0)
+                return {};
+            ret[i - 1] = dims[j - 1];
+        }
+        size_t size = std::accumulate(ret.begin(), ret.end(), size_t(1),
+                                      std::multiplies{});
+        if ((index + 1) * size > inputs[0]->size())
+            return {};
+        return {{ret}};
+    }
+
+    OpCost ViewObj::getCost() const { return {}; }
+
+    vector<int> ViewObj::getOpAttrVector() const
+    {
+        vector<int> ret{type.underlying()};
+        ret.insert(ret.end(), shape.begin(), shape.end());
+        ret.emplace_back(int(index));
+        ret.emplace_back(int(index >> 32));
+        return ret;
+    }
+
+    std::string ViewObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << "shape=" << vecToString(shape) << ",";
+        os << "index=" << index << ",";
+        os << "input=" << inputs[0]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+} // namespace infini
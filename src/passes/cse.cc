@@ -0,0 +1,89 @@
+#include "core/pass.h"
+#include <unordered_map>
+
+namespace infini
+{
+    namespace
+    {
+        struct OpKey
+        {
+            vector<int> attrs;
+            vector<UidBaseType> inputs;
+
+            bool operator==(const OpKey &rhs) const
+            {
+                return attrs == rhs.attrs && inputs == rhs.inputs;
+            }
+        };
+
+        struct OpKeyHash
+        {
+            size_t operator()(const OpKey &key) const
+            {
+                size_t h = key.attrs.size();
+                auto mix = [&h](size_t v)
+                { h ^= v + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2); };
+                for (int attr : key.attrs)
+                    mix(std::hash<int>()(attr));
+                for (auto guid : key.inputs)
+                    mix(std::hash<UidBaseType>()(guid));
+                return h;
+            }
+        };
+
+        // Graph outputs have no readers to move.
+        bool outputsRead(const Operator &op)
+        {
+            for (auto &output : op->getOutputs())
+                if (output->getTargetList().empty())
+                    return false;
+            return true;
+        }
+
+        // Moves the readers of `from`'s outputs to `to`'s and erases `from`.
+        void redirect(GraphObj &graph, const Operator &from,
+                      const Operator &to)
+        {
+            for (size_t i = 0; i < from->getOutputs().size(); ++i)
+            {
+                auto output = from->getOutput(i);
+                for (auto &reader : output->getTargets())
+                    graph.replaceInput(reader, output, to->getOutput(i));
+            }
+            graph.eraseOperator(from);
+        }
+    } // namespace
+
+    bool CommonSubexpressionElimination::run(GraphObj &graph,
+                                             PassStatistics &stats)
+    {
+        IT_ASSERT(graph.topo_sort() == true);
+        std::unordered_map<OpKey, Operator, OpKeyHash> seen;
+        bool changed = false;
+        // In topological order, so that readers of a removed duplicate are
+        // keyed by the kept outputs and deduplicated in the same sweep.
+        OpVec ops = graph.getOperators();
+        for (auto &op : ops)
+        {
+            OpKey key{op->getOpAttrVector(), {}};
+            for (auto &input : op->getInputs())
+                key.inputs.emplace_back(input->getGuid());
+            auto [it, inserted] = seen.emplace(std::move(key), op);
+            if (inserted)
+                continue;
+            auto &kept = it->second;
+            if (outputsRead(op))
+                redirect(graph, op, kept);
+            else if (outputsRead(kept))
+            {
+                redirect(graph, kept, op);
+                kept = op;
+            }
+            else
+                continue;
+            ++stats.counters["eliminated"];
+            changed = true;
+        }
+        return changed;
+    }
+} // namespace infini
@@ -0,0 +1,199 @@
+#include "core/pass.h"
+#include "operators/fused_element_wise.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+namespace infini
+{
+    namespace
+    {
+        const vector<OpType> fusibleTypes = {
+            OpType::Add,  OpType::Sub,  OpType::Mul,
+            OpType::Div,  OpType::Relu, OpType::Clip,
+            OpType::Cast, OpType::FusedElementWise};
+
+        // Regions compute in one of the types the fused kernel supports; a
+        // Cast may only convert from float to a type it can store.
+        bool isFusible(const OperatorObj &op)
+        {
+            if (std::find(fusibleTypes.begin(), fusibleTypes.end(),
+                          op.getOpType()) == fusibleTypes.end())
+                return false;
+            if (op.getOpType() == OpType::FusedElementWise)
+                return true;
+            auto dtype = op.getDType();
+            if (op.getOpType() == OpType::Cast)
+            {
+                auto to = op.getOutDType();
+                return dtype == DataType::Float32 &&
+                       (to == DataType::Float32 || to == DataType::Int64 ||
+                        to == DataType::Int32 || to == DataType::Int16 ||
+                        to == DataType::Int8);
+            }
+            if (dtype != DataType::Float32 && dtype != DataType::UInt32)
+                return false;
+            for (auto &input : op.getInputs())
+                if (input->getDType() != dtype)
+                    return false;
+            return true;
+        }
+
+        struct Region
+        {
+            TensorVec inputs;
+            vector<FusedStep> steps;
+        };
+
+        Region toRegion(const Operator &op)
+        {
+            if (auto fused = as<FusedElementWiseObj>(op))
+                return {fused->getInputs(), fused->getSteps()};
+            FusedStep step;
+            step.type = op->getOpType();
+            for (int i = 0; i < op->numInputs(); ++i)
+                step.args[i] = i;
+            if (auto clip = as<ClipObj>(op))
+            {
+                step.min = clip->getMin();
+                step.max = clip->getMax();
+            }
+            step.dtype = op->getOutDType();
+            return {op->getInputs(), {step}};
+        }
+
+        // `outer` with `inner`, which computes `link`, spliced in. Inputs
+        // read by both regions are loaded once. An `inner` without steps
+        // passes its first input through.
+        Region merge(const Region &inner, const Region &outer,
+                     const Tensor &link)
+        {
+            Region ret;
+            auto slot = [&](const Tensor &t)
+            {
+                auto it = std::find(ret.inputs.begin(), ret.inputs.end(), t);
+                if (it != ret.inputs.end())
+                    return int(it - ret.inputs.begin());
+                ret.inputs.emplace_back(t);
+                return int(ret.inputs.size()) - 1;
+            };
+            vector<int> innerSlots, outerSlots;
+            for (auto &t : inner.inputs)
+                innerSlots.emplace_back(slot(t));
+            for (auto &t : outer.inputs)
+                outerSlots.emplace_back(t == link ? -1 : slot(t));
+
+            int numInputs = ret.inputs.size();
+            int innerN = inner.inputs.size(), outerN = outer.inputs.size();
+            int innerEnd = numInputs + inner.steps.size();
+            int innerResult =
+                inner.steps.empty() ? innerSlots[0] : innerEnd - 1;
+            for (auto step : inner.steps)
+            {
+                for (auto &arg : step.args)
+                    if (arg >= 0)
+                        arg = arg < innerN ? innerSlots[arg]
+                                           : numInputs + arg - innerN;
+                ret.steps.emplace_back(step);
+            }
+            for (auto step : outer.steps)
+            {
+                for (auto &arg : step.args)
+                    if (arg >= 0)
+                        arg = arg >= outerN           ? innerEnd + arg - outerN
+                              : outerSlots[arg] >= 0 ? outerSlots[arg]
+                                                     : innerResult;
+                ret.steps.emplace_back(step);
+            }
+            return ret;
+        }
+    } // namespace
+
+    /**
+     * @brief Merges an element-wise op into its only consumer, growing fused
+     * regions one producer at a time until chains and DAGs of Add, Sub, Mul,
+     * Div, Relu, Clip and Cast are single FusedElementWise ops. Producers of
+     * a smaller, broadcast shape are not merged, since fusing would compute
+     * them once per output element.
+     */
+    class FuseElementWise : public RewritePattern
+    {
+    public:
+        FuseElementWise() : RewritePattern("FuseElementWise", fusibleTypes) {}
+
+        bool matchAndRewrite(const Operator &op,
+                             PatternRewriter &rewriter) const override
+        {
+            if (!isFusible(*op))
+                return false;
+            for (auto &input : op->getInputs())
+            {
+                auto producer = input->getSource();
+                // Constants are computed once by foldConstants; fused, they
+                // would be recomputed on every run.
+                if (!producer || input->isConstant() ||
+                    !isFusible(*producer) || !onlyUsedBy(input, op.get()) ||
+                    input->getDims() != op->getOutput()->getDims())
+                    continue;
+                auto inner = toRegion(producer);
+                // A Cast can only end a region.
+                if (inner.steps.back().type == OpType::Cast)
+                    continue;
+                auto merged = merge(inner, toRegion(op), input);
+                rewriter.replaceOpWithNew<FusedElementWiseObj>(
+                    op, merged.inputs, op->getOutput(), merged.steps);
+                return true;
+            }
+            return false;
+        }
+    };
+
+    /**
+     * @brief Moves an element-wise op, or a fused region, reading a MatMul's
+     * product into the MatMul's epilogue, e.g. MatMul -> Add(bias) -> Relu
+     * becomes one MatMul that adds the bias and clamps each row before
+     * storing it. The product must have no other reader and keep its shape.
+     */
+    class FuseMatmulEpilogue : public RewritePattern
+    {
+    public:
+        FuseMatmulEpilogue()
+            : RewritePattern("FuseMatmulEpilogue", fusibleTypes) {}
+
+        bool matchAndRewrite(const Operator &op,
+                             PatternRewriter &rewriter) const override
+        {
+            if (!isFusible(*op))
+                return false;
+            for (auto &input : op->getInputs())
+            {
+                auto matmul = as<MatmulObj>(input->getSource());
+                if (!matmul || input->isConstant() ||
+                    !onlyUsedBy(input, op.get()) ||
+                    input->getDims() != op->getOutput()->getDims())
+                    continue;
+                auto dtype = matmul->getOutDType();
+                const auto &epilogue = matmul->getEpilogue();
+                if ((dtype != DataType::Float32 && dtype != DataType::UInt32) ||
+                    (!epilogue.empty() && epilogue.back().type == OpType::Cast))
+                    continue;
+                // Value 0 of the epilogue is the product, which no tensor
+                // holds.
+                Region inner{{nullptr}, epilogue};
+                inner.inputs.insert(inner.inputs.end(),
+                                    matmul->getInputs().begin() + 2,
+                                    matmul->getInputs().end());
+                auto merged = merge(inner, toRegion(op), input);
+                rewriter.replaceOpWithNew<MatmulObj>(
+                    op, matmul->getInputs(0), matmul->getInputs(1),
+                    op->getOutput(), matmul->getTransA(), matmul->getTransB(),
+                    TensorVec(merged.inputs.begin() + 1, merged.inputs.end()),
+                    merged.steps);
+                return true;
+            }
+            return false;
+        }
+    };
+
+    REGISTER_PATTERN(FuseElementWise);
+    REGISTER_PATTERN(FuseMatmulEpilogue);
+} // namespace infini
@@ -0,0 +1,80 @@
+#include "core/pass.h"
+#include "operators/concat.h"
+#include "operators/matmul.h"
+#include "operators/view.h"
+
+namespace infini
+{
+    namespace
+    {
+        // A plain MatMul by a constant matrix, e.g. a projection weight.
+        bool isMergeable(const MatmulObj &op)
+        {
+            const auto &A = op.getInputs(0), &B = op.getInputs(1);
+            return op.getEpilogue().empty() && !op.getPackedB() &&
+                   B->getRank() == 2 && B->isConstant() && !A->isConstant() &&
+                   A != B && A->getRank() < kMaxRank;
+        }
+    } // namespace
+
+    /**
+     * @brief Merges MatMuls that multiply the same A by constant weights of
+     * one shape, such as Q/K/V projections, into one MatMul. The weights are
+     * concatenated and viewed as a stack [G, 1.., K, N], so each original
+     * product is a contiguous slice of the merged one and is read through a
+     * View, which follows A's batch dims when the graph is resized. The
+     * Concat only reads constants and is folded at load time.
+     */
+    class MergeSiblingMatmuls : public RewritePattern
+    {
+    public:
+        MergeSiblingMatmuls()
+            : RewritePattern("MergeSiblingMatmuls", {OpType::MatMul}) {}
+
+        bool matchAndRewrite(const Operator &root,
+                             PatternRewriter &rewriter) const override
+        {
+            auto op = as<MatmulObj>(root);
+            if (!isMergeable(*op))
+                return false;
+            const auto A = op->getInputs(0), B = op->getInputs(1);
+            vector<Ref<MatmulObj>> group{op};
+            for (auto &reader : A->getTargets())
+            {
+                auto mm = as<MatmulObj>(reader);
+                if (mm && mm != op && mm->getInputs(0) == A &&
+                    isMergeable(*mm) && mm->getTransA() == op->getTransA() &&
+                    mm->getTransB() == op->getTransB() &&
+                    mm->getInputs(1)->getDims() == B->getDims() &&
+                    mm->getInputs(1)->getDType() == B->getDType())
+                    group.emplace_back(mm);
+            }
+            if (group.size() < 2)
+                return false;
+
+            TensorVec weights;
+            for (auto &mm : group)
+                weights.emplace_back(mm->getInputs(1));
+            auto cat = rewriter.addOp<ConcatObj>(weights, nullptr, 0);
+            Shape stacked(A->getRank() + 1, 1);
+            stacked[0] = group.size();
+            stacked[A->getRank() - 1] = B->getDims()[0];
+            stacked[A->getRank()] = B->getDims()[1];
+            auto w = rewriter.addOp<ViewObj>(cat->getOutput(), nullptr,
+                                             stacked);
+            auto wide = rewriter.addOp<MatmulObj>(A, w->getOutput(), nullptr,
+                                                  op->getTransA(),
+                                                  op->getTransB());
+            for (size_t i = 0; i < group.size(); ++i)
+            {
+                auto output = group[i]->getOutput();
+                rewriter.replaceOpWithNew<ViewObj>(
+                    group[i], wide->getOutput(), output,
+                    Shape(output->getRank(), 0), i);
+            }
+            return true;
+        }
+    };
+
+    REGISTER_PATTERN(MergeSiblingMatmuls);
+} // namespace infini
@@ -0,0 +1,386 @@
+#include "core/pass.h"
+#include "operators/concat.h"
+#include "operators/fused_element_wise.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+#include "utils/operator_utils.h"
+#include <numeric>
+
+namespace infini
+{
+    namespace
+    {
+        // Types holding every value of `from` exactly, so that a Cast to
+        // them and back is the identity.
+        bool widens(DataType from, DataType to)
+        {
+            static const vector<std::pair<DataType, vector<DataType>>> wider{
+                {DataType::Int8,
+                 {DataType::Int16, DataType::Int32, DataType::Int64,
+                  DataType::Float32}},
+                {DataType::UInt8,
+                 {DataType::Int16, DataType::Int32, DataType::Int64,
+                  DataType::Float32}},
+                {DataType::Int16,
+                 {DataType::Int32, DataType::Int64, DataType::Float32}},
+                {DataType::Int32, {DataType::Int64}},
+                {DataType::UInt32, {DataType::Int64}},
+                {DataType::Float16, {DataType::Float32}},
+                {DataType::BFloat16, {DataType::Float32}}};
+            for (auto &[type, types] : wider)
+                if (type == from)
+                    return std::find(types.begin(), types.end(), to) !=
+                           types.end();
+            return false;
+        }
+
+        template <typename T>
+        bool allEqual(const Tensor &tensor, T value)
+        {
+            auto ptr = tensor->getRawDataPtr<T *>();
+            return std::all_of(ptr, ptr + tensor->size(),
+                               [&](T x) { return x == value; });
+        }
+
+        // True if every element of the constant `tensor` equals `value`.
+        bool isSplat(const Tensor &tensor, int value)
+        {
+            if (!tensor->isConstant())
+                return false;
+            auto dtype = tensor->getDType();
+            if (dtype == DataType::Float32)
+                return allEqual<float>(tensor, value);
+            if (dtype == DataType::Int32)
+                return allEqual<int32_t>(tensor, value);
+            if (dtype == DataType::Int64)
+                return allEqual<int64_t>(tensor, value);
+            if (dtype == DataType::UInt32)
+                return allEqual<uint32_t>(tensor, value);
+            return false;
+        }
+
+        // The operand an Add or Sub of zeros or a Mul or Div by ones passes
+        // through, or -1. inputs[v] is the tensor of value v, if any.
+        int passedValue(const FusedStep &step, const TensorVec &inputs)
+        {
+            auto type = step.type;
+            if (type != OpType::Add && type != OpType::Sub &&
+                type != OpType::Mul && type != OpType::Div)
+                return -1;
+            int identity = type == OpType::Add || type == OpType::Sub ? 0 : 1;
+            auto isIdentity = [&](int v)
+            {
+                return v < int(inputs.size()) && inputs[v] &&
+                       isSplat(inputs[v], identity);
+            };
+            if (isIdentity(step.args[1]))
+                return step.args[0];
+            if ((type == OpType::Add || type == OpType::Mul) &&
+                isIdentity(step.args[0]))
+                return step.args[1];
+            return -1;
+        }
+
+        /**
+         * Drops the identity steps (see passedValue) of a fused program
+         * whose values i < inputs.size() have `shapes`, unless that would
+         * change the shape of a value. Readers of a dropped step read the
+         * value it passed through instead. Returns the value holding the
+         * result, or -1 if nothing was dropped or the program would not end
+         * in its result.
+         */
+        int dropIdentitySteps(const TensorVec &inputs, vector<Shape> shapes,
+                              vector<FusedStep> &steps)
+        {
+            int numInputs = inputs.size();
+            vector<int> remap(numInputs + steps.size());
+            std::iota(remap.begin(), remap.begin() + numInputs, 0);
+            vector<FusedStep> kept;
+            for (size_t k = 0; k < steps.size(); ++k)
+            {
+                FusedStep step = steps[k];
+                for (auto &arg : step.args)
+                    if (arg >= 0)
+                        arg = remap[arg];
+                Shape shape = step.args[1] < 0
+                                  ? shapes[step.args[0]]
+                                  : infer_broadcast(shapes[step.args[0]],
+                                                    shapes[step.args[1]]);
+                int pass = passedValue(step, inputs);
+                if (pass >= 0 && shapes[pass] == shape)
+                {
+                    remap[numInputs + k] = pass;
+                    continue;
+                }
+                remap[numInputs + k] = numInputs + kept.size();
+                kept.emplace_back(step);
+                shapes.emplace_back(shape);
+            }
+            int result = remap.back();
+            if (kept.size() == steps.size() ||
+                (result >= numInputs &&
+                 result != numInputs + int(kept.size()) - 1) ||
+                (result < numInputs && !kept.empty()))
+                return -1;
+            steps = std::move(kept);
+            return result;
+        }
+
+        // Removes the inputs from `first` on that no step reads.
+        void dropUnusedInputs(TensorVec &inputs, vector<FusedStep> &steps,
+                              size_t first)
+        {
+            vector<bool> used(inputs.size());
+            for (auto &step : steps)
+                for (auto arg : step.args)
+                    if (arg >= 0 && arg < int(inputs.size()))
+                        used[arg] = true;
+            vector<int> remap(inputs.size() + steps.size());
+            TensorVec kept;
+            for (size_t i = 0; i < inputs.size(); ++i)
+                if (i < first || used[i])
+                {
+                    remap[i] = kept.size();
+                    kept.emplace_back(inputs[i]);
+                }
+            for (size_t k = 0; k < steps.size(); ++k)
+                remap[inputs.size() + k] = kept.size() + k;
+            for (auto &step : steps)
+                for (auto &arg : step.args)
+                    if (arg >= 0)
+                        arg = remap[arg];
+            inputs = std::move(kept);
+        }
+    } // namespace
+
+    /**
+     * @brief Clip without bounds is the identity.
+     */
+    class EraseUnboundedClip : public RewritePattern
+    {
+    public:
+        EraseUnboundedClip()
+            : RewritePattern("EraseUnboundedClip", {OpType::Clip}, 2) {}
+
+        bool matchAndRewrite(const Operator &op,
+                             PatternRewriter &rewriter) const override
+        {
+            auto clip = as<ClipObj>(op);
+            return !clip->getMin() && !clip->getMax() &&
+                   rewriter.replaceOpWithValue(clip, clip->getInputs(0));
+        }
+    };
+
+    /**
+     * @brief Relu(Relu(x)) == Relu(x) and Relu(Clip(x, lo, hi)) ==
+     * Clip(x, max(lo, 0), max(hi, 0)).
+     */
+    class MergeReluIntoProducer : public RewritePattern
+    {
+    public:
+        MergeReluIntoProducer()
+            : RewritePattern("MergeReluIntoProducer", {OpType::Relu}, 2) {}
+
+        bool matchAndRewrite(const Operator &op,
+                             PatternRewriter &rewriter) const override
+        {
+            auto src = op->getInputs(0)->getSource();
+            if (!src)
+                return false;
+            if (src->getOpType() == OpType::Relu)
+            {
+                rewriter.replaceOpWithNew<ReluObj>(op, src->getInputs(0),
+                                                   op->getOutput());
+                return true;
+            }
+            auto clip = as<ClipObj>(src);
+            if (!clip)
+                return false;
+            auto lo = clip->getMin(), hi = clip->getMax();
+            rewriter.replaceOpWithNew<ClipObj>(
+                op, clip->getInputs(0), op->getOutput(),
+                lo ? std::max(*lo, 0.f) : 0.f,
+                hi ? std::optional<float>(std::max(*hi, 0.f)) : std::nullopt);
+            return true;
+        }
+    };
+
+    /**
+     * @brief Clip(Relu(x), lo, hi) == Clip(x, max(lo, 0), hi) unless
+     * hi < max(lo, 0).
+     */
+    class MergeReluIntoClip : public RewritePattern
+    {
+    public:
+        MergeReluIntoClip()
+            : RewritePattern("MergeReluIntoClip", {OpType::Clip}, 2) {}
+
+        bool matchAndRewrite(const Operator &op,
+                             PatternRewriter &rewriter) const override
+        {
+            auto clip = as<ClipObj>(op);
+            auto src = clip->getInputs(0)->getSource();
+            if (!src || src->getOpType() != OpType::Relu)
+                return false;
+            float lo = std::max(clip->getMin().value_or(0.f), 0.f);
+            auto hi = clip->getMax();
+            if (hi && *hi < lo)
+                return false;
+            rewriter.replaceOpWithNew<ClipObj>(op, src->getInputs(0),
+                                               op->getOutput(), lo, hi);
+            return true;
+        }
+    };
+
+    /**
+     * @brief Drops a Cast to the input's own type and a Cast back from a
+     * type that held every input value exactly, e.g. Int8 -> Float -> Int8.
+     */
+    class EraseRedundantCast : public RewritePattern
+    {
+    public:
+        EraseRedundantCast()
+            : RewritePattern("EraseRedundantCast", {OpType::Cast}, 2) {}
+
+        bool matchAndRewrite(const Operator &op,
+                             PatternRewriter &rewriter) const override
+        {
+            auto input = op->getInputs(0);
+            if (input->getDType() == op->getOutDType())
+                return rewriter.replaceOpWithValue(op, input);
+            auto src = input->getSource();
+            if (!src || src->getOpType() != OpType::Cast)
+                return false;
+            auto x = src->getInputs(0);
+            return x->getDType() == op->getOutDType() &&
+                   widens(x->getDType(), input->getDType()) &&
+                   rewriter.replaceOpWithValue(op, x);
+        }
+    };
+
+    /**
+     * @brief Drops a Concat of one input and splices the inputs of a
+     * Concat on the same axis into the Concat reading it.
+     */
+    class SimplifyConcat : public RewritePattern
+    {
+    public:
+        SimplifyConcat()
+            : RewritePattern("SimplifyConcat", {OpType::Concat}, 2) {}
+
+        bool matchAndRewrite(const Operator &op,
+                             PatternRewriter &rewriter) const override
+        {
+            auto concat = as<ConcatObj>(op);
+            if (concat->numInputs() == 1)
+                return rewriter.replaceOpWithValue(concat,
+                                                   concat->getInputs(0));
+            TensorVec inputs;
+            bool nested = false;
+            for (auto &input : concat->getInputs())
+            {
+                auto inner = as<ConcatObj>(input->getSource());
+                if (inner && inner->getDim() == concat->getDim())
+                {
+                    inputs.insert(inputs.end(), inner->getInputs().begin(),
+                                  inner->getInputs().end());
+                    nested = true;
+                }
+                else
+                    inputs.emplace_back(input);
+            }
+            if (!nested)
+                return false;
+            rewriter.replaceOpWithNew<ConcatObj>(
+                concat, inputs, concat->getOutput(), concat->getDim());
+            return true;
+        }
+    };
+
+    /**
+     * @brief Drops Add and Sub of constant zeros and Mul and Div by constant
+     * ones, as operators or as steps of fused regions and MatMul epilogues,
+     * where they do not broadcast the other operand. Runs at load time,
+     * when the constants' values are known.
+     */
+    class EraseIdentityArithmetic : public RewritePattern
+    {
+    public:
+        EraseIdentityArithmetic()
+            : RewritePattern("EraseIdentityArithmetic",
+                             {OpType::Add, OpType::Sub, OpType::Mul,
+                              OpType::Div, OpType::FusedElementWise,
+                              OpType::MatMul}) {}
+
+        bool matchAndRewrite(const Operator &op,
+                             PatternRewriter &rewriter) const override
+        {
+            if (auto fused = as<FusedElementWiseObj>(op))
+                return rewriteFused(fused, rewriter);
+            if (auto matmul = as<MatmulObj>(op))
+                return rewriteMatmul(matmul, rewriter);
+            auto inputs = op->getInputs();
+            FusedStep step;
+            step.type = op->getOpType();
+            step.args[0] = 0;
+            step.args[1] = 1;
+            int pass = passedValue(step, inputs);
+            return pass >= 0 &&
+                   inputs[pass]->getDims() == op->getOutput()->getDims() &&
+                   rewriter.replaceOpWithValue(op, inputs[pass]);
+        }
+
+    private:
+        bool rewriteFused(const Ref<FusedElementWiseObj> &op,
+                          PatternRewriter &rewriter) const
+        {
+            auto inputs = op->getInputs();
+            auto steps = op->getSteps();
+            vector<Shape> shapes;
+            for (auto &input : inputs)
+                shapes.emplace_back(input->getDims());
+            int result = dropIdentitySteps(inputs, shapes, steps);
+            if (result < 0)
+                return false;
+            if (steps.empty())
+                return inputs[result]->getDType() == op->getOutDType() &&
+                       rewriter.replaceOpWithValue(op, inputs[result]);
+            dropUnusedInputs(inputs, steps, 0);
+            rewriter.replaceOpWithNew<FusedElementWiseObj>(
+                op, inputs, op->getOutput(), steps);
+            return true;
+        }
+
+        bool rewriteMatmul(const Ref<MatmulObj> &op,
+                           PatternRewriter &rewriter) const
+        {
+            auto steps = op->getEpilogue();
+            if (steps.empty())
+                return false;
+            // Value 0 is the product, which no tensor holds.
+            TensorVec inputs{nullptr};
+            inputs.insert(inputs.end(), op->getInputs().begin() + 2,
+                          op->getInputs().end());
+            vector<Shape> shapes{op->getOutput()->getDims()};
+            for (size_t i = 1; i < inputs.size(); ++i)
+                shapes.emplace_back(inputs[i]->getDims());
+            int result = dropIdentitySteps(inputs, shapes, steps);
+            if (result < 0 || (steps.empty() && result != 0))
+                return false;
+            dropUnusedInputs(inputs, steps, 1);
+            auto ret = rewriter.replaceOpWithNew<MatmulObj>(
+                op, op->getInputs(0), op->getInputs(1), op->getOutput(),
+                op->getTransA(), op->getTransB(),
+                TensorVec(inputs.begin() + 1, inputs.end()), steps);
+            ret->setPackedB(op->getPackedB());
+            return true;
+        }
+    };
+
+    REGISTER_PATTERN(EraseUnboundedClip);
+    REGISTER_PATTERN(MergeReluIntoProducer);
+    REGISTER_PATTERN(MergeReluIntoClip);
+    REGISTER_PATTERN(EraseRedundantCast);
+    REGISTER_PATTERN(SimplifyConcat);
+    REGISTER_LOAD_PATTERN(EraseIdentityArithmetic);
+} // namespace infini
@@ -0,0 +1,317 @@
+#include "core/pass.h"
+#include "operators/concat.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+
+namespace infini
+{
+    namespace
+    {
+        // Erases `op` once nothing reads its output any more.
+        void eraseIfUnused(const Operator &op, PatternRewriter &rewriter)
+        {
+            if (rewriter.getGraph().hasOperator(op) &&
+                op->getOutput()->getTargetList().empty())
+                rewriter.eraseOp(op);
+        }
+
+        bool isIdentity(const vector<int> &perm)
+        {
+            for (size_t i = 0; i < perm.size(); ++i)
+                if (perm[i] != int(i))
+                    return false;
+            return true;
+        }
+
+        // Transpose(Transpose(x, p1), p2) == Transpose(x, composed).
+        vector<int> compose(const vector<int> &p1, const vector<int> &p2)
+        {
+            vector<int> composed(p2.size());
+            for (size_t i = 0; i < p2.size(); ++i)
+                composed[i] = p1[p2[i]];
+            return composed;
+        }
+
+        // Ops computing every output element from the input elements at the
+        // same index, so a Transpose can move from their inputs to their
+        // output.
+        const vector<OpType> layoutAgnosticTypes = {
+            OpType::Relu, OpType::Clip, OpType::Cast,
+            OpType::Add,  OpType::Sub,  OpType::Mul,
+            OpType::Div,  OpType::FusedElementWise};
+
+        bool isLayoutAgnostic(const OperatorObj &op)
+        {
+            return std::find(layoutAgnosticTypes.begin(),
+                             layoutAgnosticTypes.end(),
+                             op.getOpType()) != layoutAgnosticTypes.end();
+        }
+
+        // The Transpose producing `input` if `op` is its only consumer.
+        Ref<TransposeObj> soleTranspose(const Tensor &input,
+                                        const OperatorObj *op)
+        {
+            auto transpose = as<TransposeObj>(input->getSource());
+            if (!transpose || !onlyUsedBy(input, op))
+                return nullptr;
+            return transpose;
+        }
+
+        bool swapsLastTwoDims(const vector<int> &perm)
+        {
+            size_t rank = perm.size();
+            if (rank < 2)
+                return false;
+            for (size_t i = 0; i + 2 < rank; ++i)
+                if (perm[i] != int(i))
+                    return false;
+            return perm[rank - 2] == int(rank - 1) &&
+                   perm[rank - 1] == int(rank - 2);
+        }
+    } // namespace
+
+    /**
+     * @brief Transpose(Transpose(x, p1), p2) becomes Transpose(x, p) with
+     * p[i] = p1[p2[i]]. The outer op is updated in place, so this also works
+     * when it produces a graph output; the inner one is erased once unused.
+     */
+    class ComposeTransposes : public RewritePattern
+    {
+    public:
+        ComposeTransposes()
+            : RewritePattern("ComposeTransposes", {OpType::Transpose}) {}
+
+        bool matchAndRewrite(const Operator &op,
+                             PatternRewriter &rewriter) const override
+        {
+            auto outer = as<TransposeObj>(op);
+            auto inner = as<TransposeObj>(outer->getInputs(0)->getSource());
+            if (!inner || !rewriter.getGraph().hasOperator(inner))
+                return false;
+            auto composed = compose(inner->getPermute(), outer->getPermute());
+            rewriter.replaceInput(outer, inner->getOutput(),
+                                  inner->getInputs(0));
+            outer->setPermute(std::move(composed));
+            rewriter.modified(outer);
+            eraseIfUnused(inner, rewriter);
+            return true;
+        }
+    };
+
+    /**
+     * @brief Consumers of an identity Transpose read its input directly.
+     */
+    class EliminateIdentityTranspose : public RewritePattern
+    {
+    public:
+        EliminateIdentityTranspose()
+            : RewritePattern("EliminateIdentityTranspose", {OpType::Transpose},
+                             2) {}
+
+        bool matchAndRewrite(const Operator &op,
+                             PatternRewriter &rewriter) const override
+        {
+            auto transpose = as<TransposeObj>(op);
+            return isIdentity(transpose->getPermute()) &&
+                   rewriter.replaceOpWithValue(transpose,
+                                               transpose->getInputs(0));
+        }
+    };
+
+    /**
+     * @brief A MatMul operand produced by a Transpose that only swaps the
+     * last two dims is read untransposed with transA/transB flipped. A
+     * Transpose with other consumers stays for them.
+     */
+    class FoldTransposeIntoMatmul : public RewritePattern
+    {
+    public:
+        FoldTransposeIntoMatmul()
+            : RewritePattern("FoldTransposeIntoMatmul", {OpType::MatMul}) {}
+
+        bool matchAndRewrite(const Operator &op,
+                             PatternRewriter &rewriter) const override
+        {
+            auto matmul = as<MatmulObj>(op);
+            bool changed = false;
+            for (int i = 0; i < 2; ++i)
+            {
+                auto input = matmul->getInputs(i);
+                auto transpose = as<TransposeObj>(input->getSource());
+                if (!transpose || !swapsLastTwoDims(transpose->getPermute()))
+                    continue;
+                // Rewiring replaces every use, so a shared operand flips both.
+                bool shared = matmul->getInputs(0) == matmul->getInputs(1);
+                rewriter.replaceInput(matmul, input, transpose->getInputs(0));
+                if (i == 0 || shared)
+                    matmul->setTransA(!matmul->getTransA());
+                if (i == 1 || shared)
+                    matmul->setTransB(!matmul->getTransB());
+                eraseIfUnused(transpose, rewriter);
+                changed = true;
+                if (shared)
+                    break;
+            }
+            if (changed)
+                rewriter.modified(matmul);
+            return changed;
+        }
+    };
+
+    /**
+     * @brief Op(Transpose(x, p), Transpose(y, p), ...) becomes
+     * Transpose(Op(x, y, ...), p) for a layout-agnostic op. Single-element
+     * operands broadcast the same either way. Sinking moves transposes
+     * towards each other and towards MatMuls, where they cancel or fold.
+     */
+    class SinkTranspose : public RewritePattern
+    {
+    public:
+        SinkTranspose()
+            : RewritePattern("SinkTranspose", layoutAgnosticTypes) {}
+
+        bool matchAndRewrite(const Operator &op,
+                             PatternRewriter &rewriter) const override
+        {
+            // A graph output has no consumers to rewire.
+            if (op->getOutput()->getTargetList().empty())
+                return false;
+            vector<int> perm;
+            TensorVec inputs;
+            for (auto &input : op->getInputs())
+            {
+                auto transpose = soleTranspose(input, op.get());
+                if (!transpose)
+                {
+                    if (input->size() != 1)
+                        return false;
+                    inputs.emplace_back(input);
+                    continue;
+                }
+                if (!perm.empty() && perm != transpose->getPermute())
+                    return false;
+                perm = transpose->getPermute();
+                inputs.emplace_back(transpose->getInputs(0));
+            }
+            if (perm.empty() ||
+                perm.size() != size_t(op->getOutput()->getRank()))
+                return false;
+            auto moved = rewriter.cloneOp(op, inputs);
+            auto transpose =
+                rewriter.addOp<TransposeObj>(moved->getOutput(), nullptr, perm);
+            rewriter.replaceAllUses(op->getOutput(), transpose->getOutput());
+            rewriter.eraseOp(op);
+            return true;
+        }
+    };
+
+    /**
+     * @brief Transpose(Op(Transpose(x, p1), Transpose(y, p2)), q) becomes
+     * Op(Transpose(x, p1∘q), Transpose(y, p2∘q)), dropping one Transpose.
+     * Only for operands transposed differently: equal permutations are
+     * sunk below the op instead.
+     */
+    class HoistTranspose : public RewritePattern
+    {
+    public:
+        HoistTranspose()
+            : RewritePattern("HoistTranspose", {OpType::Transpose}) {}
+
+        bool matchAndRewrite(const Operator &op,
+                             PatternRewriter &rewriter) const override
+        {
+            auto transpose = as<TransposeObj>(op);
+            auto src = transpose->getInputs(0)->getSource();
+            if (!src || !isLayoutAgnostic(*src) ||
+                !onlyUsedBy(src->getOutput(), op.get()) ||
+                transpose->getOutput()->getTargetList().empty())
+                return false;
+            const auto &q = transpose->getPermute();
+            vector<Ref<TransposeObj>> operands;
+            bool samePerm = true;
+            for (auto &input : src->getInputs())
+            {
+                auto inner = soleTranspose(input, src.get());
+                if (!inner && input->size() != 1)
+                    return false;
+                if (inner && inner->getPermute().size() != q.size())
+                    return false;
+                if (inner)
+                    for (auto &other : operands)
+                        if (other && other->getPermute() != inner->getPermute())
+                            samePerm = false;
+                operands.emplace_back(inner);
+            }
+            auto transposed =
+                std::count_if(operands.begin(), operands.end(),
+                              [](auto &t) { return t != nullptr; });
+            if (transposed < 2 || samePerm)
+                return false;
+            TensorVec inputs;
+            for (size_t i = 0; i < operands.size(); ++i)
+            {
+                if (!operands[i])
+                {
+                    inputs.emplace_back(src->getInputs(i));
+                    continue;
+                }
+                auto perm = compose(operands[i]->getPermute(), q);
+                auto x = operands[i]->getInputs(0);
+                inputs.emplace_back(
+                    isIdentity(perm)
+                        ? x
+                        : rewriter.addOp<TransposeObj>(x, nullptr, perm)
+                              ->getOutput());
+            }
+            auto moved = rewriter.cloneOp(src, inputs);
+            rewriter.replaceAllUses(transpose->getOutput(), moved->getOutput());
+            rewriter.eraseOp(transpose);
+            return true;
+        }
+    };
+
+    /**
+     * @brief Concat(Transpose(x, p), Transpose(y, p), axis) becomes
+     * Transpose(Concat(x, y, p[axis]), p).
+     */
+    class SinkTransposeThroughConcat : public RewritePattern
+    {
+    public:
+        SinkTransposeThroughConcat()
+            : RewritePattern("SinkTransposeThroughConcat", {OpType::Concat}) {}
+
+        bool matchAndRewrite(const Operator &op,
+                             PatternRewriter &rewriter) const override
+        {
+            auto concat = as<ConcatObj>(op);
+            if (concat->getOutput()->getTargetList().empty())
+                return false;
+            vector<int> perm;
+            TensorVec inputs;
+            for (auto &input : concat->getInputs())
+            {
+                auto transpose = soleTranspose(input, op.get());
+                if (!transpose ||
+                    (!perm.empty() && perm != transpose->getPermute()))
+                    return false;
+                perm = transpose->getPermute();
+                inputs.emplace_back(transpose->getInputs(0));
+            }
+            auto moved = rewriter.addOp<ConcatObj>(inputs, nullptr,
+                                                   perm[concat->getDim()]);
+            auto transpose =
+                rewriter.addOp<TransposeObj>(moved->getOutput(), nullptr, perm);
+            rewriter.replaceAllUses(concat->getOutput(),
+                                    transpose->getOutput());
+            rewriter.eraseOp(concat);
+            return true;
+        }
+    };
+
+    REGISTER_PATTERN(ComposeTransposes);
+    REGISTER_PATTERN(EliminateIdentityTranspose);
+    REGISTER_PATTERN(FoldTransposeIntoMatmul);
+    REGISTER_PATTERN(SinkTranspose);
+    REGISTER_PATTERN(HoistTranspose);
+    REGISTER_PATTERN(SinkTransposeThroughConcat);
+} // namespace infini
@@ -0,0 +1,38 @@
+#include "utils/logging.h"
+#include <atomic>
+#include <cstdlib>
+#include <strings.h>
+#include <iostream>
+
+namespace infini {
+
+namespace {
+LogLevel levelFromEnv() {
+    const char *value = std::getenv("INFINI_LOG_LEVEL");
+    if (!value)
+        return LogLevel::Warn;
+    const char *names[] = {"off", "warn", "info", "debug"};
+    for (int i = 0; i < 4; ++i)
+        if (!strcasecmp(value, names[i]) || value == std::to_string(i))
+            return LogLevel(i);
+    return LogLevel::Warn;
+}
+
+std::atomic<LogLevel> &currentLevel() {
+    static std::atomic<LogLevel> level{levelFromEnv()};
+    return level;
+}
+} // namespace
+
+LogLevel getLogLevel() { return currentLevel().load(std::memory_order_relaxed); }
+
+void setLogLevel(LogLevel level) {
+    currentLevel().store(level, std::memory_order_relaxed);
+}
+
+void logMessage(LogLevel level, const std::string &msg) {
+    static const char *tags[] = {"", "warn", "info", "debug"};
+    std::cerr << "[infini:" << tags[int(level)] << "] " + msg + "\n";
+}
+
+} // namespace infini
@@ -1,5 +1,6 @@
 #include "utils/operator_utils.h"
 #include "core/runtime.h"
+#include <cstring>
 namespace infini {
 
 Shape infer_broadcast(const Shape &A, const Shape &B) {
@@ -46,31 +47,46 @@ int get_real_axis(const int &axis, const int &rank) {
     return newAxis;
 }
 
+Shape pad_to_bucket(Shape dims, int axis, const vector<ShapeElem> &buckets) {
+    axis = get_real_axis(axis, dims.size());
+    std::optional<ShapeElem> padded;
+    for (auto bucket : buckets)
+        if (bucket >= dims[axis] && (!padded || bucket < *padded))
+            padded = bucket;
+    dims[axis] = padded.value_or(dims[axis]);
+    return dims;
+}
+
 Shape locate_index(size_t inputN, const Shape &shape) {
     Shape ans(shape.size());
     auto i = ans.rbegin();
     auto j = shape.rbegin(), ej = shape.rend();
     while (j != ej) {
-        auto div = std::div(inputN, *j++);
-        *i++ = div.rem;
-        inputN = div.quot;
+        size_t dim = *j++;
+        *i++ = inputN % dim;
+        inputN /= dim;
     }
     return ans;
 }
 
 size_t delocate_index(const Shape &shapeIndex, const Shape &shape,
-                      const Shape &stride) {
+                      const Stride &stride) {
     size_t ans = 0;
-    Shape index(shapeIndex.size());
     IT_ASSERT(shapeIndex.size() == shape.size());
     IT_ASSERT(shape.size() == stride.size());
-    for (size_t i = 0; i < shape.size(); ++i) {
-        index[i] = shapeIndex[i] % shape[i];
-        ans += index[i] * stride[i];
-    }
+    for (size_t i = 0; i < shape.size(); ++i)
+        ans += size_t(shapeIndex[i] % shape[i]) * stride[i];
     return ans;
 }
 
+void append_attr(vector<int> &attrs, std::optional<float> value) {
+    int bits = 0;
+    if (value)
+        std::memcpy(&bits, &*value, sizeof(bits));
+    attrs.emplace_back(value.has_value());
+    attrs.emplace_back(bits);
+}
+
 std::string device_to_str(Device device) {
     std::string deviceStr;
     switch (device) {
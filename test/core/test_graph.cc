@@ -1,10 +1,16 @@
 #include "core/graph.h"
 #include "core/kernel.h"
 #include "core/runtime.h"
+#include "operators/element_wise.h"
 #include "operators/matmul.h"
 #include "operators/transpose.h"
+#include "operators/unary.h"
+#include "utils/data_generator.h"
+#include "utils/operator_utils.h"
 
 #include "test.h"
+#include <thread>
+#include <unordered_set>
 
 namespace infini
 {
@@ -37,4 +43,322 @@ namespace infini
         EXPECT_EQ(op->getTransA(), false);
         EXPECT_EQ(op->getTransB(), true);
     }
+
+    TEST(Graph, Indices)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i = g->addTensor({2, 3});
+        auto r0 = g->addOp<ReluObj>(i, nullptr);
+        auto r1 = g->addOp<ReluObj>(r0->getOutput(), nullptr);
+        auto r2 = g->addOp<ReluObj>(r1->getOutput(), nullptr);
+        EXPECT_EQ(g->getTensor(r1->getOutput()->getFuid()), r1->getOutput());
+        EXPECT_EQ(g->getTensor(-1), nullptr);
+        EXPECT_TRUE(g->hasOperator(r1));
+        EXPECT_THROW(g->addTensor(i), Exception);
+
+        // Positions stay valid across removals and compaction.
+        Tensor dead = r1->getOutput();
+        g->removeOperator(r1);
+        g->removeTensor(dead);
+        EXPECT_FALSE(g->hasOperator(r1));
+        EXPECT_FALSE(g->hasTensor(dead));
+        EXPECT_EQ(g->getTensor(dead->getFuid()), nullptr);
+        EXPECT_EQ(g->getOperators(), (OpVec{r0, r2}));
+        g->removeOperator(r2);
+        g->removeOperator(r2);
+        EXPECT_EQ(g->getOperators(), (OpVec{r0}));
+        EXPECT_EQ(g->getTensors(),
+                  (TensorVec{i, r0->getOutput(), r2->getOutput()}));
+    }
+
+    TEST(Graph, TopoSort)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i = g->addTensor({2, 3});
+        Tensor t0 = g->addTensor({2, 3});
+        Tensor t1 = g->addTensor({2, 3});
+        Tensor o = g->addTensor({2, 3});
+        // Consumers first: each producer is moved ahead of them on insertion.
+        auto r2 = g->addOpWithOutputs<ReluObj>(t1, o);
+        auto r1 = g->addOpWithOutputs<ReluObj>(t0, t1);
+        auto r0 = g->addOpWithOutputs<ReluObj>(i, t0);
+        EXPECT_EQ(g->getOperators(), (OpVec{r0, r1, r2}));
+
+        auto side = g->addOp<ReluObj>(i, nullptr);
+        g->replaceInput(side, i, o);
+        EXPECT_EQ(g->getOperators(), (OpVec{r0, r1, r2, side}));
+        EXPECT_EQ(side->getPredecessors(), (OpVec{r2}));
+        EXPECT_TRUE(g->checkValid());
+        // Feeding r0 from the tail closes a cycle.
+        g->replaceInput(r0, i, side->getOutput());
+        EXPECT_FALSE(g->topo_sort());
+        g->replaceInput(r0, side->getOutput(), i);
+        EXPECT_TRUE(g->topo_sort());
+        EXPECT_EQ(g->getOperators(), (OpVec{r0, r1, r2, side}));
+    }
+
+    TEST(Graph, FoldConstants)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({2, 3});
+        Tensor w1 = g->addTensor({3, 2});
+        Tensor w2 = g->addTensor({3, 2});
+        w1->setConstant();
+        w2->setConstant();
+        auto sum = g->addOp<AddObj>(w1, w2, nullptr);
+        auto t = g->addOp<TransposeObj>(sum->getOutput(), nullptr,
+                                        Shape{1, 0});
+        Tensor wt = t->getOutput();
+        EXPECT_TRUE(wt->isConstant());
+        auto add = g->addOp<AddObj>(x, wt, nullptr);
+        Tensor y = g->addOp<ReluObj>(add->getOutput(), nullptr)->getOutput();
+        EXPECT_FALSE(y->isConstant());
+
+        // Fusion leaves the constant Transpose out of the region.
+        g->optimize();
+        EXPECT_EQ(g->getOperators().size(), 3);
+        g->dataMalloc();
+        x->setData(IncrementalGenerator());
+        w1->setData(IncrementalGenerator());
+        w2->setData(IncrementalGenerator());
+        EXPECT_EQ(g->foldConstants(), 2);
+        EXPECT_EQ(g->getOperators().size(), 1);
+        EXPECT_FALSE(g->hasTensor(w1));
+        EXPECT_FALSE(g->hasTensor(w2));
+        EXPECT_EQ(g->getInputs(), (TensorVec{x, wt}));
+        EXPECT_TRUE(g->checkValid());
+        EXPECT_TRUE(wt->equalData(vector<float>{0, 4, 8, 2, 6, 10}));
+
+        runtime->run(g);
+        EXPECT_TRUE(y->equalData(vector<float>{0, 5, 10, 5, 10, 15}));
+        EXPECT_EQ(g->foldConstants(), 0);
+    }
+
+    TEST(Graph, FoldConstantsMarkedAfterReaders)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto build = [&](Graph g, bool late)
+        {
+            Tensor x = g->addTensor({64, 64});
+            Tensor w = g->addTensor({64, 64});
+            if (!late)
+                w->setConstant();
+            auto t = g->addOp<TransposeObj>(w, nullptr, Shape{1, 0});
+            auto mm = g->addOp<MatmulObj>(x, t->getOutput(), nullptr);
+            auto r = g->addOp<ReluObj>(mm->getOutput(), nullptr);
+            Tensor y = g->addOp<ReluObj>(r->getOutput(), nullptr)->getOutput();
+            if (late)
+                w->setConstant();
+            g->dataMalloc();
+            x->setData(IncrementalGenerator());
+            w->setData(IncrementalGenerator());
+            return y;
+        };
+        Graph ref = make_ref<GraphObj>(runtime);
+        Tensor expected = build(ref, false);
+        EXPECT_EQ(ref->foldConstants(), 1);
+        runtime->run(ref);
+
+        // dataMalloc spreads the late mark, so the Transpose output is placed
+        // with the weights and folded as well.
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor y = build(g, true);
+        EXPECT_EQ(g->foldConstants(), 1);
+        EXPECT_EQ(g->getOperators().size(), 3u);
+        EXPECT_TRUE(g->checkValid());
+        runtime->run(g);
+        EXPECT_TRUE(y->equalData(expected));
+    }
+
+    TEST(Graph, FoldConstantsKeepsGraphOutputs)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({2, 3});
+        Tensor w = g->addTensor({2, 3});
+        w->setConstant();
+        Tensor wr = g->addOp<ReluObj>(w, nullptr)->getOutput();
+        Tensor y = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        g->dataMalloc();
+        x->setData(IncrementalGenerator());
+        w->setData(IncrementalGenerator());
+        EXPECT_EQ(g->foldConstants(), 0);
+        EXPECT_TRUE(g->checkValid());
+        EXPECT_EQ(g->getOutputs(), (TensorVec{wr, y}));
+        runtime->run(g);
+        EXPECT_TRUE(wr->equalData(vector<float>{0, 1, 2, 3, 4, 5}));
+    }
+
+    TEST(Graph, ResizeInputs)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        // Sibling projections of x, merged into one MatMul when optimised.
+        auto build = [&](Graph g, Shape dims)
+        {
+            Tensor x = g->addTensor(dims);
+            TensorVec outs;
+            for (int i = 0; i < 2; ++i)
+            {
+                Tensor w = g->addTensor({4, 5});
+                w->setConstant();
+                outs.emplace_back(
+                    g->addOp<MatmulObj>(x, w, nullptr)->getOutput());
+            }
+            return std::make_pair(
+                x, g->addOp<SubObj>(outs[0], outs[1], nullptr)->getOutput());
+        };
+        auto fill = [](const TensorVec &tensors)
+        {
+            for (auto &t : tensors)
+                t->setData(IncrementalGenerator());
+        };
+        auto expected = [&](Shape dims)
+        {
+            Graph ref = make_ref<GraphObj>(runtime);
+            auto out = build(ref, dims).second;
+            ref->dataMalloc();
+            fill(ref->getInputs());
+            runtime->run(ref);
+            return out;
+        };
+
+        Graph g = make_ref<GraphObj>(runtime);
+        auto [x, out] = build(g, {2, 3, 4});
+        g->optimize();
+        g->dataMalloc();
+        fill(g->getInputs());
+        g->foldConstants();
+        g->packConstants();
+        runtime->run(g);
+        EXPECT_TRUE(out->equalData(expected({2, 3, 4})));
+
+        // Constants keep their data; the new shapes get their own buffers.
+        for (auto dims : {Shape{5, 3, 4}, Shape{2, 3, 4}, Shape{5, 7, 4}})
+        {
+            g->resize({x}, {dims});
+            EXPECT_EQ(out->getDims(), (Shape{dims[0], dims[1], 5}));
+            x->setData(IncrementalGenerator());
+            runtime->run(g);
+            EXPECT_TRUE(out->equalData(expected(dims)));
+        }
+        EXPECT_EQ(g->getPlanCount(), 3u);
+
+        EXPECT_EQ(pad_to_bucket({3, 4}, 0, {8, 2, 4}), (Shape{4, 4}));
+        EXPECT_EQ(pad_to_bucket({3, 4}, -1, {8, 2, 4}), (Shape{3, 4}));
+        EXPECT_EQ(pad_to_bucket({9, 4}, 0, {8, 2, 4}), (Shape{9, 4}));
+    }
+
+    TEST(Graph, ActivationArena)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        struct Net
+        {
+            Graph g;
+            Tensor x, w, out;
+            TensorVec hidden;
+        };
+        auto build = [&](Shape dims)
+        {
+            Net net{make_ref<GraphObj>(runtime)};
+            net.x = net.g->addTensor(dims);
+            net.w = net.g->addTensor({4, 4});
+            net.w->setConstant();
+            Tensor t = net.x;
+            for (int i = 0; i < 2; ++i)
+            {
+                t = net.g->addOp<TransposeObj>(t, nullptr, Shape{1, 0})
+                        ->getOutput();
+                net.hidden.emplace_back(t);
+                t = net.g->addOp<ReluObj>(t, nullptr)->getOutput();
+                net.hidden.emplace_back(t);
+            }
+            net.out = net.g->addOp<MatmulObj>(t, net.w, nullptr)->getOutput();
+            return net;
+        };
+        auto run = [&](const Net &net)
+        {
+            net.x->setData(IncrementalGenerator());
+            runtime->run(net.g);
+            auto ptr = net.out->getRawDataPtr<float *>();
+            return vector<float>(ptr, ptr + net.out->size());
+        };
+
+        auto small = build({4, 4});
+        small.g->dataMalloc();
+        small.w->setData(IncrementalGenerator());
+        // Four intermediates of 64 bytes, at most two of them live at once.
+        EXPECT_EQ(small.g->getArena()->getSize(), 128u);
+        EXPECT_EQ(small.hidden[0]->getRawDataPtr<float *>(),
+                  small.hidden[2]->getRawDataPtr<float *>());
+        auto expected = run(small);
+
+        // A larger graph sharing the arena grows it; the small one binds
+        // again before it runs.
+        auto large = build({8, 4});
+        large.g->setArena(small.g->getArena());
+        large.g->dataMalloc();
+        large.w->setData(IncrementalGenerator());
+        EXPECT_EQ(small.g->getArena()->getSize(), 256u);
+        auto ref = build({8, 4});
+        ref.g->dataMalloc();
+        ref.w->setData(IncrementalGenerator());
+        EXPECT_EQ(run(large), run(ref));
+        EXPECT_EQ(run(small), expected);
+
+        // Re-planning never moves the weights.
+        auto weights = small.w->getRawDataPtr<float *>();
+        small.g->resize({small.x}, {{8, 4}});
+        EXPECT_EQ(small.w->getRawDataPtr<float *>(), weights);
+        EXPECT_EQ(run(small), run(ref));
+    }
+
+    TEST(Graph, ConcurrentBuild)
+    {
+        constexpr int kThreads = 4;
+        vector<vector<float>> results(kThreads);
+        vector<vector<UidBaseType>> guids(kThreads);
+        vector<std::thread> threads;
+        for (int i = 0; i < kThreads; ++i)
+            threads.emplace_back(
+                [&, i]
+                {
+                    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+                    Graph g = make_ref<GraphObj>(runtime);
+                    Tensor x = g->addTensor({8, 16});
+                    Tensor t = x;
+                    for (int j = 0; j < 4; ++j)
+                    {
+                        Tensor w = g->addTensor({16, 16});
+                        w->setConstant();
+                        t = g->addOp<MatmulObj>(t, w, nullptr)->getOutput();
+                        t = g->addOp<ReluObj>(t, nullptr)->getOutput();
+                    }
+                    g->optimize();
+                    g->dataMalloc();
+                    for (auto &input : g->getInputs())
+                        input->setData(IncrementalGenerator());
+                    g->foldConstants();
+                    g->packConstants();
+                    runtime->run(g);
+                    auto ptr = t->getRawDataPtr<float *>();
+                    results[i].assign(ptr, ptr + t->size());
+                    for (auto &tensor : g->getTensors())
+                        guids[i].emplace_back(tensor->getGuid());
+                    for (auto &op : g->getOperators())
+                        guids[i].emplace_back(op->getGuid());
+                });
+        for (auto &thread : threads)
+            thread.join();
+
+        std::unordered_set<UidBaseType> seen;
+        for (int i = 0; i < kThreads; ++i)
+        {
+            EXPECT_EQ(results[i], results[0]);
+            for (auto guid : guids[i])
+                EXPECT_TRUE(seen.insert(guid).second);
+        }
+    }
 }
@@ -0,0 +1,41 @@
+#include "core/tensor.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(InlineVector, VectorInterface)
+    {
+        Shape s{2, 3, 4};
+        EXPECT_EQ(s.size(), 3u);
+        EXPECT_EQ(s.back(), 4);
+        s.insert(s.begin() + 1, 5);
+        EXPECT_EQ(s, (Shape{2, 5, 3, 4}));
+        // An element of the vector itself, moved by the insertion.
+        s.insert(s.begin(), s.back());
+        EXPECT_EQ(s, (Shape{4, 2, 5, 3, 4}));
+        s.erase(s.begin());
+        Shape self{1, 2, 3};
+        self.insert(self.begin() + 1, self.begin(), self.end());
+        EXPECT_EQ(self, (Shape{1, 1, 2, 3, 2, 3}));
+        s.erase(s.begin(), s.begin() + 2);
+        EXPECT_EQ(s, (Shape{3, 4}));
+        EXPECT_EQ(Shape(s.rbegin(), s.rend()), (Shape{4, 3}));
+        EXPECT_EQ(Shape(2, 1), (Shape{1, 1}));
+        EXPECT_EQ(vecToString(s), "[3,4]");
+
+        vector<int> v = s;
+        EXPECT_EQ(v, (vector<int>{3, 4}));
+        EXPECT_EQ(Shape(v), s);
+    }
+
+    TEST(InlineVector, Capacity)
+    {
+        Shape s(kMaxRank, 1);
+        EXPECT_THROW(s.push_back(1), Exception);
+        EXPECT_THROW(Shape(kMaxRank + 1), Exception);
+        s.pop_back();
+        s.push_back(2);
+        EXPECT_EQ(s.back(), 2);
+    }
+} // namespace infini
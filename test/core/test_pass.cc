@@ -0,0 +1,506 @@
+#include "core/graph.h"
+#include "core/pass.h"
+#include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/fused_element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include "operators/view.h"
+
+#include "test.h"
+
+namespace infini
+{
+    namespace
+    {
+        // Rewrites Relu(Relu(x)) to Relu(x).
+        class DropRepeatedRelu : public RewritePattern
+        {
+        public:
+            DropRepeatedRelu() : RewritePattern("DropRepeatedRelu", {OpType::Relu}) {}
+
+            bool matchAndRewrite(const Operator &op,
+                                 PatternRewriter &rewriter) const override
+            {
+                auto src = op->getInputs(0)->getSource();
+                if (!src || src->getOpType() != OpType::Relu ||
+                    op->getOutput()->getTargetList().empty())
+                    return false;
+                rewriter.replaceAllUses(op->getOutput(), src->getOutput());
+                rewriter.eraseOp(op);
+                return true;
+            }
+        };
+
+        // Runs `build` twice, optimising the second graph, and checks both
+        // give the same single output on the same inputs. Returns the
+        // optimised graph.
+        Graph checkOptimizedMatches(const std::function<void(Graph)> &build)
+        {
+            Runtime runtime = NativeCpuRuntimeObj::getInstance();
+            Graph ref = make_ref<GraphObj>(runtime);
+            Graph opt = make_ref<GraphObj>(runtime);
+            build(ref);
+            build(opt);
+            opt->optimize();
+            EXPECT_TRUE(opt->checkValid());
+            for (auto &g : {ref, opt})
+            {
+                g->dataMalloc();
+                for (auto &input : g->getInputs())
+                    input->setData(IncrementalGenerator());
+                runtime->run(g);
+            }
+            EXPECT_EQ(ref->getOutputs().size(), 1u);
+            EXPECT_EQ(opt->getOutputs().size(), 1u);
+            EXPECT_TRUE(opt->getOutputs()[0]->equalData(ref->getOutputs()[0]));
+            return opt;
+        }
+    } // namespace
+
+    TEST(Pass, FixedPointAndStatistics)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({2, 3});
+        Tensor t = x;
+        for (int i = 0; i < 5; ++i)
+            t = g->addOp<ReluObj>(t, nullptr)->getOutput();
+        auto tail = g->addOp<TransposeObj>(t, nullptr, vector<int>{1, 0});
+
+        PassManager pm;
+        pm.addPass<PatternRewritePass>(
+            "Relu", vector<std::shared_ptr<RewritePattern>>{
+                        std::make_shared<DropRepeatedRelu>()});
+        pm.setVerify(true);
+        EXPECT_TRUE(pm.run(*g));
+        EXPECT_EQ(g->getOperators().size(), 2u);
+        EXPECT_EQ(tail->getInputs(0)->getSource()->getOpType(), OpType::Relu);
+        EXPECT_EQ(pm.getStatistics()[0].counters.at("DropRepeatedRelu"), 4u);
+        EXPECT_EQ(pm.getStatistics()[0].runs, 2u);
+        EXPECT_EQ(pm.getStatistics()[0].changes, 1u);
+        EXPECT_NE(pm.statistics().find("DropRepeatedRelu"), string::npos);
+        EXPECT_FALSE(pm.run(*g));
+    }
+
+    TEST(Pass, TransposePatterns)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor a = g->addTensor({2, 4, 3});
+        Tensor b = g->addTensor({2, 4, 5});
+        // tA feeds both the MatMul and a Relu, so it must survive the fold.
+        auto tA = g->addOp<TransposeObj>(a, nullptr, vector<int>{0, 2, 1});
+        auto relu = g->addOp<ReluObj>(tA->getOutput(), nullptr);
+        auto tB1 = g->addOp<TransposeObj>(b, nullptr, vector<int>{2, 0, 1});
+        auto tB2 = g->addOp<TransposeObj>(tB1->getOutput(), nullptr,
+                                          vector<int>{1, 2, 0});
+        auto mm = g->addOp<MatmulObj>(tA->getOutput(), tB2->getOutput(),
+                                      nullptr);
+        // A transpose producing a graph output stays.
+        auto out = g->addOp<TransposeObj>(mm->getOutput(), nullptr,
+                                          vector<int>{0, 2, 1});
+        g->optimize();
+        EXPECT_TRUE(g->checkValid());
+        EXPECT_EQ(g->getOperators(), (OpVec{tA, relu, mm, out}));
+        EXPECT_EQ(mm->getInputs(), (TensorVec{a, b}));
+        EXPECT_TRUE(mm->getTransA());
+        EXPECT_FALSE(mm->getTransB());
+        EXPECT_EQ(g->getOutputs(),
+                  (TensorVec{relu->getOutput(), out->getOutput()}));
+    }
+
+    TEST(Pass, TransposeComposition)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({2, 3, 4});
+        auto t0 = g->addOp<TransposeObj>(x, nullptr,
+                                                  vector<int>{1, 2, 0});
+        auto relu = g->addOp<ReluObj>(t0->getOutput(), nullptr);
+        // Composes with t0, which stays for the Relu; the result is a graph
+        // output.
+        auto t1 = g->addOp<TransposeObj>(t0->getOutput(), nullptr,
+                                         vector<int>{0, 2, 1});
+        // An operand shared by both sides of a MatMul.
+        auto sq = g->addOp<TransposeObj>(g->addTensor({3, 2, 2}), nullptr,
+                                         vector<int>{0, 2, 1});
+        auto mm = g->addOp<MatmulObj>(sq->getOutput(), sq->getOutput(), nullptr);
+        g->optimize();
+        EXPECT_TRUE(g->checkValid());
+        EXPECT_EQ(g->getOperators(), (OpVec{t0, relu, t1, mm}));
+        EXPECT_EQ(t1->getInputs(0), x);
+        EXPECT_EQ(t1->getPermute(), (vector<int>{1, 0, 2}));
+        EXPECT_EQ(t1->getOutput()->getDims(), (Shape{3, 2, 4}));
+        EXPECT_EQ(mm->getInputs(0), mm->getInputs(1));
+        EXPECT_EQ(mm->getInputs(0)->getSource(), nullptr);
+        EXPECT_TRUE(mm->getTransA());
+        EXPECT_TRUE(mm->getTransB());
+    }
+
+    TEST(Pass, TransposeSinking)
+    {
+        // Transpose -> Relu -> Clip -> Add -> Transpose cancels out, leaving
+        // the element-wise ops to be fused.
+        auto g = checkOptimizedMatches(
+            [](Graph g)
+            {
+                Tensor x = g->addTensor({2, 3, 4});
+                Tensor s = g->addTensor(Shape{1});
+                Tensor w = g->addTensor({2, 4, 5});
+                auto t0 = g->addOp<TransposeObj>(x, nullptr,
+                                                 vector<int>{0, 2, 1});
+                auto relu = g->addOp<ReluObj>(t0->getOutput(), nullptr);
+                auto clip = g->addOp<ClipObj>(relu->getOutput(), nullptr, 1.f,
+                                              20.f);
+                auto add = g->addOp<AddObj>(clip->getOutput(), s, nullptr);
+                auto t1 = g->addOp<TransposeObj>(add->getOutput(), nullptr,
+                                                 vector<int>{0, 2, 1});
+                g->addOp<MatmulObj>(t1->getOutput(), w, nullptr);
+            });
+        auto ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 2u);
+        EXPECT_EQ(ops[0]->getOpType(), OpType::FusedElementWise);
+        EXPECT_EQ(ops[0]->getInputs(0)->getDims(), (Shape{2, 3, 4}));
+        EXPECT_EQ(ops[1]->getOpType(), OpType::MatMul);
+        EXPECT_EQ(ops[1]->getInputs(0), ops[0]->getOutput());
+
+        // Differently transposed operands: the outer Transpose moves above
+        // the Add and cancels on one side.
+        g = checkOptimizedMatches(
+            [](Graph g)
+            {
+                Tensor a = g->addTensor({2, 3, 4});
+                Tensor b = g->addTensor({2, 4, 3});
+                auto ta = g->addOp<TransposeObj>(a, nullptr,
+                                                 vector<int>{1, 0, 2});
+                auto tb = g->addOp<TransposeObj>(b, nullptr,
+                                                 vector<int>{2, 0, 1});
+                auto add = g->addOp<AddObj>(ta->getOutput(), tb->getOutput(),
+                                            nullptr);
+                auto t = g->addOp<TransposeObj>(add->getOutput(), nullptr,
+                                                vector<int>{1, 0, 2});
+                g->addOp<ReluObj>(t->getOutput(), nullptr);
+            });
+        ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 2u);
+        auto fused = ops[1];
+        EXPECT_EQ(fused->getOpType(), OpType::FusedElementWise);
+        EXPECT_EQ(fused->getInputs(0)->getSource(), nullptr);
+        auto tb = as<TransposeObj>(fused->getInputs(1)->getSource());
+        EXPECT_EQ(tb->getPermute(), (vector<int>{0, 2, 1}));
+
+        // Concat of equally transposed inputs concatenates along the
+        // permuted axis.
+        g = checkOptimizedMatches(
+            [](Graph g)
+            {
+                Tensor a = g->addTensor({2, 3});
+                Tensor b = g->addTensor({2, 5});
+                auto ta = g->addOp<TransposeObj>(a, nullptr, vector<int>{1, 0});
+                auto tb = g->addOp<TransposeObj>(b, nullptr, vector<int>{1, 0});
+                auto concat = g->addOp<ConcatObj>(
+                    TensorVec{ta->getOutput(), tb->getOutput()}, nullptr, 0);
+                auto t = g->addOp<TransposeObj>(concat->getOutput(), nullptr,
+                                                vector<int>{1, 0});
+                g->addOp<ReluObj>(t->getOutput(), nullptr);
+            });
+        ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 2u);
+        EXPECT_EQ(as<ConcatObj>(ops[0])->getDim(), 1);
+        EXPECT_EQ(ops[1]->getInputs(0)->getDims(), (Shape{2, 8}));
+    }
+
+    TEST(Pass, ElementWiseFusion)
+    {
+        // A diamond ending in a graph output: the output tensor is kept.
+        Tensor out;
+        auto g = checkOptimizedMatches(
+            [&](Graph g)
+            {
+                Tensor x = g->addTensor({4, 5});
+                Tensor bias = g->addTensor(Shape{5});
+                auto add = g->addOp<AddObj>(x, bias, nullptr);
+                auto relu = g->addOp<ReluObj>(add->getOutput(), nullptr);
+                auto mul = g->addOp<MulObj>(relu->getOutput(),
+                                            add->getOutput(), nullptr);
+                auto clip = g->addOp<ClipObj>(mul->getOutput(), nullptr,
+                                              std::nullopt, 300.f);
+                out = g->addOp<CastObj>(clip->getOutput(), nullptr,
+                                        CastType::Float2Int32)
+                          ->getOutput();
+            });
+        auto ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 1u);
+        auto fused = as<FusedElementWiseObj>(ops[0]);
+        EXPECT_EQ(fused->getOutput(), out);
+        EXPECT_EQ(fused->getInputs(), g->getInputs());
+        vector<OpType> types;
+        for (auto &step : fused->getSteps())
+            types.emplace_back(step.type);
+        EXPECT_EQ(types, (vector<OpType>{OpType::Add, OpType::Relu,
+                                         OpType::Mul, OpType::Clip,
+                                         OpType::Cast}));
+
+        // A broadcast operand is computed once, outside the region, and a
+        // Cast ends one.
+        g = checkOptimizedMatches(
+            [](Graph g)
+            {
+                Tensor x = g->addTensor({4, 5});
+                Tensor bias = g->addTensor(Shape{5});
+                Tensor s = g->addTensor(Shape{1});
+                auto scaled = g->addOp<MulObj>(bias, s, nullptr);
+                auto add = g->addOp<AddObj>(x, scaled->getOutput(), nullptr);
+                auto relu = g->addOp<ReluObj>(add->getOutput(), nullptr);
+                auto cast = g->addOp<CastObj>(relu->getOutput(), nullptr,
+                                              CastType::Float2Int32);
+                auto back = g->addOp<CastObj>(cast->getOutput(), nullptr,
+                                              CastType::Int322Float);
+                g->addOp<SubObj>(back->getOutput(), x, nullptr);
+            });
+        ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 4u);
+        EXPECT_EQ(ops[0]->getOpType(), OpType::Mul);
+        EXPECT_EQ(as<FusedElementWiseObj>(ops[1])->getSteps().size(), 3u);
+        EXPECT_EQ(ops[2]->getOpType(), OpType::Cast);
+        EXPECT_EQ(ops[3]->getOpType(), OpType::Sub);
+    }
+
+    TEST(Pass, MatmulEpilogue)
+    {
+        Tensor out;
+        auto g = checkOptimizedMatches(
+            [&](Graph g)
+            {
+                Tensor a = g->addTensor({2, 3, 4});
+                Tensor b = g->addTensor({4, 5});
+                Tensor bias = g->addTensor(Shape{5});
+                auto mm = g->addOp<MatmulObj>(a, b, nullptr);
+                auto add = g->addOp<AddObj>(mm->getOutput(), bias, nullptr);
+                auto relu = g->addOp<ReluObj>(add->getOutput(), nullptr);
+                out = g->addOp<ClipObj>(relu->getOutput(), nullptr,
+                                        std::nullopt, 100.f)
+                          ->getOutput();
+            });
+        auto ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 1u);
+        auto mm = as<MatmulObj>(ops[0]);
+        EXPECT_EQ(mm->getOutput(), out);
+        EXPECT_EQ(mm->getInputs(), g->getInputs());
+        vector<OpType> types;
+        for (auto &step : mm->getEpilogue())
+            types.emplace_back(step.type);
+        EXPECT_EQ(types,
+                  (vector<OpType>{OpType::Add, OpType::Relu, OpType::Clip}));
+
+        // A product read elsewhere is stored as is.
+        g = checkOptimizedMatches(
+            [](Graph g)
+            {
+                Tensor a = g->addTensor({3, 4});
+                Tensor b = g->addTensor({4, 5});
+                auto mm = g->addOp<MatmulObj>(a, b, nullptr);
+                auto relu = g->addOp<ReluObj>(mm->getOutput(), nullptr);
+                auto t = g->addOp<TransposeObj>(mm->getOutput(), nullptr,
+                                                vector<int>{1, 0});
+                g->addOp<MatmulObj>(relu->getOutput(), t->getOutput(),
+                                    nullptr);
+            });
+        ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 3u);
+        EXPECT_TRUE(as<MatmulObj>(ops[0])->getEpilogue().empty());
+        EXPECT_EQ(ops[1]->getOpType(), OpType::Relu);
+        EXPECT_TRUE(as<MatmulObj>(ops[2])->getTransB());
+    }
+
+    TEST(Pass, CommonSubexpressionElimination)
+    {
+        auto build = [](Graph g)
+        {
+            Tensor x = g->addTensor({2, 3});
+            auto t1 = g->addOp<TransposeObj>(x, nullptr, vector<int>{1, 0});
+            auto t2 = g->addOp<TransposeObj>(x, nullptr, vector<int>{1, 0});
+            auto r1 = g->addOp<ReluObj>(t1->getOutput(), nullptr);
+            auto r2 = g->addOp<ReluObj>(t2->getOutput(), nullptr);
+            // Different bounds, so these stay apart.
+            auto c1 = g->addOp<ClipObj>(r1->getOutput(), nullptr,
+                                        std::nullopt, 1.f);
+            auto c2 = g->addOp<ClipObj>(r2->getOutput(), nullptr,
+                                        std::nullopt, 2.f);
+            g->addOp<AddObj>(c1->getOutput(), c2->getOutput(), nullptr);
+        };
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        build(g);
+        // Duplicates that are both graph outputs are kept.
+        Tensor x = g->getInputs()[0];
+        g->addOp<ReluObj>(x, nullptr);
+        g->addOp<ReluObj>(x, nullptr);
+
+        PassManager pm;
+        pm.addPass<CommonSubexpressionElimination>();
+        pm.setVerify(true);
+        EXPECT_TRUE(pm.run(*g));
+        EXPECT_EQ(pm.getStatistics()[0].counters.at("eliminated"), 2u);
+        vector<OpType> types;
+        for (auto &op : g->getOperators())
+            types.emplace_back(op->getOpType());
+        EXPECT_EQ(types, (vector<OpType>{OpType::Transpose, OpType::Relu,
+                                         OpType::Clip, OpType::Clip,
+                                         OpType::Add, OpType::Relu,
+                                         OpType::Relu}));
+        EXPECT_FALSE(pm.run(*g));
+
+        checkOptimizedMatches(build);
+    }
+
+    TEST(Pass, SiblingMatmulMerge)
+    {
+        TensorVec outs;
+        auto g = checkOptimizedMatches(
+            [&](Graph g)
+            {
+                Tensor x = g->addTensor({2, 3, 4});
+                outs.clear();
+                for (int i = 0; i < 3; ++i)
+                {
+                    Tensor w = g->addTensor({5, 4});
+                    w->setConstant();
+                    outs.emplace_back(
+                        g->addOp<MatmulObj>(x, w, nullptr, false, true)
+                            ->getOutput());
+                }
+                auto qk = g->addOp<MulObj>(outs[0], outs[1], nullptr);
+                g->addOp<SubObj>(qk->getOutput(), outs[2], nullptr);
+            });
+        vector<Ref<MatmulObj>> matmuls;
+        for (auto &op : g->getOperators())
+            if (auto mm = as<MatmulObj>(op))
+                matmuls.emplace_back(mm);
+        ASSERT_EQ(matmuls.size(), 1u);
+        EXPECT_EQ(matmuls[0]->getOutput()->getDims(), (Shape{3, 2, 3, 5}));
+        EXPECT_EQ(matmuls[0]->getInputs(1)->getDims(), (Shape{3, 1, 5, 4}));
+        EXPECT_TRUE(matmuls[0]->getInputs(1)->isConstant());
+        for (size_t i = 0; i < outs.size(); ++i)
+        {
+            auto view = as<ViewObj>(outs[i]->getSource());
+            ASSERT_TRUE(view);
+            EXPECT_EQ(view->getInputs(0), matmuls[0]->getOutput());
+            EXPECT_EQ(view->getIndex(), i);
+            // Views share the product's buffer.
+            EXPECT_EQ(outs[i]->getRawDataPtr<float *>(),
+                      matmuls[0]->getOutput()->getRawDataPtr<float *>() +
+                          i * 30);
+        }
+        EXPECT_EQ(g->foldConstants(), 2u);
+    }
+
+    TEST(Pass, AlgebraicSimplification)
+    {
+        Tensor x;
+        auto g = checkOptimizedMatches(
+            [&](Graph g)
+            {
+                x = g->addTensor({2, 3});
+                auto c = g->addOp<ClipObj>(x, nullptr, std::nullopt,
+                                           std::nullopt);
+                auto r1 = g->addOp<ReluObj>(c->getOutput(), nullptr);
+                auto r2 = g->addOp<ReluObj>(r1->getOutput(), nullptr);
+                g->addOp<ClipObj>(r2->getOutput(), nullptr, std::nullopt,
+                                  6.f);
+            });
+        auto ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 1u);
+        auto clip = as<ClipObj>(ops[0]);
+        ASSERT_TRUE(clip);
+        EXPECT_EQ(clip->getInputs(0), x);
+        EXPECT_EQ(clip->getMin(), 0.f);
+        EXPECT_EQ(clip->getMax(), 6.f);
+
+        // Int32 -> Int64 -> Int32 is exact; Float -> Int32 -> Float is not.
+        g = checkOptimizedMatches(
+            [](Graph g)
+            {
+                Tensor y = g->addTensor({2, 3});
+                auto i = g->addOp<CastObj>(y, nullptr, CastType::Float2Int32);
+                auto wide = g->addOp<CastObj>(i->getOutput(), nullptr,
+                                              CastType::Int322Int64);
+                auto back = g->addOp<CastObj>(wide->getOutput(), nullptr,
+                                              CastType::Int642Int32);
+                g->addOp<CastObj>(back->getOutput(), nullptr,
+                                  CastType::Int322Float);
+            });
+        ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 2u);
+        EXPECT_EQ(as<CastObj>(ops[0])->getType(), CastType::Float2Int32);
+        EXPECT_EQ(ops[1]->getInputs(0), ops[0]->getOutput());
+
+        TensorVec inputs;
+        g = checkOptimizedMatches(
+            [&](Graph g)
+            {
+                inputs = {g->addTensor({1, 3}), g->addTensor({2, 3}),
+                          g->addTensor({1, 3})};
+                auto inner = g->addOp<ConcatObj>(
+                    TensorVec{inputs[0], inputs[1]}, nullptr, 0);
+                auto single =
+                    g->addOp<ConcatObj>(TensorVec{inputs[2]}, nullptr, 0);
+                g->addOp<ConcatObj>(
+                    TensorVec{inner->getOutput(), single->getOutput()},
+                    nullptr, 0);
+            });
+        ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 1u);
+        EXPECT_EQ(ops[0]->getInputs(), inputs);
+    }
+
+    TEST(Pass, LoadTimeIdentityArithmetic)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({2, 3});
+        Tensor zeros = g->addTensor({2, 3});
+        Tensor ones = g->addTensor(Shape{3});
+        Tensor a = g->addTensor({2, 4});
+        Tensor b = g->addTensor({4, 3});
+        for (auto &t : {zeros, ones, b})
+            t->setConstant();
+        auto add = g->addOp<AddObj>(x, zeros, nullptr);
+        auto relu = g->addOp<ReluObj>(add->getOutput(), nullptr);
+        auto mul = g->addOp<MulObj>(ones, relu->getOutput(), nullptr);
+        auto product = g->addOp<MatmulObj>(a, b, nullptr);
+        auto bias = g->addOp<SubObj>(product->getOutput(), zeros, nullptr);
+        auto sum = g->addOp<AddObj>(mul->getOutput(), bias->getOutput(),
+                                    nullptr);
+        Tensor out = sum->getOutput();
+        // Everything fuses into the MatMul's epilogue.
+        g->optimize();
+        ASSERT_EQ(g->getOperators().size(), 1u);
+        auto fused = as<MatmulObj>(g->getOperators()[0]);
+        ASSERT_TRUE(fused);
+        EXPECT_EQ(fused->getEpilogue().size(), 5u);
+
+        g->dataMalloc();
+        x->setData(IncrementalGenerator());
+        a->setData(IncrementalGenerator());
+        b->setData(IncrementalGenerator());
+        zeros->setData(ValGenerator<0>());
+        ones->setData(ValGenerator<1>());
+        EXPECT_EQ(g->foldConstants(), 0u);
+        EXPECT_TRUE(g->checkValid());
+        ASSERT_EQ(g->getOperators().size(), 1u);
+        auto mm = as<MatmulObj>(g->getOperators()[0]);
+        EXPECT_EQ(mm->getInputs(), (TensorVec{a, b, x}));
+        vector<OpType> types;
+        for (auto &step : mm->getEpilogue())
+            types.emplace_back(step.type);
+        EXPECT_EQ(types, (vector<OpType>{OpType::Relu, OpType::Add}));
+        runtime->run(g);
+        // Relu(x) + a * b.
+        vector<float> expected{42, 49, 56, 117, 140, 163};
+        EXPECT_TRUE(out->equalData(expected));
+    }
+} // namespace infini
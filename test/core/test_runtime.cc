@@ -0,0 +1,148 @@
+#include "core/graph.h"
+#include "core/profiler.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(Runtime, CostBasedThreads)
+    {
+        ThreadPoolConfig config;
+        config.numThreads = 4;
+        config.minWorkPerThread = 1 << 16;
+        auto runtime = make_ref<NativeCpuRuntimeObj>(config);
+        Graph g = make_ref<GraphObj>(runtime);
+        auto small = g->addOp<ReluObj>(g->addTensor(Shape{64}), nullptr);
+        auto big = g->addOp<AddObj>(g->addTensor({1024, 1024}),
+                                    g->addTensor(Shape{1024}), nullptr);
+        EXPECT_EQ(runtime->getNumThreadsFor(small), 1);
+        EXPECT_EQ(runtime->getNumThreadsFor(big), 4);
+
+        config.numThreads = 1;
+        runtime->setThreadPoolConfig(config);
+        EXPECT_EQ(runtime->getNumThreadsFor(big), 1);
+    }
+
+    TEST(Runtime, ParallelRunMatchesSerial)
+    {
+        vector<vector<float>> results;
+        for (int threads : {1, 3})
+        {
+            ThreadPoolConfig config;
+            config.numThreads = threads;
+            config.minWorkPerThread = 1;
+            auto runtime = make_ref<NativeCpuRuntimeObj>(config);
+            Graph g = make_ref<GraphObj>(runtime);
+            auto a = g->addTensor({7, 33, 65});
+            auto b = g->addTensor({33, 1});
+            auto add = g->addOp<AddObj>(a, b, nullptr);
+            auto relu = g->addOp<ReluObj>(add->getOutput(), nullptr);
+            g->dataMalloc();
+            a->setData(IncrementalGenerator());
+            b->setData(IncrementalGenerator());
+            runtime->run(g);
+            auto out = relu->getOutput();
+            auto ptr = out->getRawDataPtr<float *>();
+            results.emplace_back(ptr, ptr + out->size());
+        }
+        EXPECT_EQ(results[0], results[1]);
+    }
+
+    TEST(Runtime, Profiler)
+    {
+        auto runtime = make_ref<NativeCpuRuntimeObj>();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({2, 3});
+        auto b = g->addTensor(Shape{3});
+        auto add = g->addOp<AddObj>(a, b, nullptr);
+        g->addOp<ReluObj>(add->getOutput(), nullptr);
+        g->dataMalloc();
+
+        runtime->run(g);
+        EXPECT_TRUE(runtime->getProfiler().getRecords().empty());
+
+        runtime->setProfiling(true);
+        runtime->run(g);
+        runtime->run(g);
+        runtime->setProfiling(false);
+        auto records = runtime->getProfiler().getRecords();
+        ASSERT_EQ(records.size(), size_t(4));
+        EXPECT_EQ(records[0].opType, OpType::Add);
+        EXPECT_EQ(records[0].kernelName, "addNaive_CPU");
+        EXPECT_EQ(records[0].inputShapes, (vector<Shape>{{2, 3}, {3}}));
+        EXPECT_EQ(records[1].kernelName, "reluNaive_CPU");
+        EXPECT_EQ(records[1].dtype, DataType::Float32);
+        EXPECT_LE(records[0].startUs, records[2].startUs);
+
+        auto summary = runtime->getProfiler().summary();
+        EXPECT_NE(summary.find("Add"), string::npos);
+        EXPECT_NE(summary.find("Relu"), string::npos);
+        auto trace = runtime->getProfiler().toChromeTrace();
+        EXPECT_EQ(trace.find("{\"displayTimeUnit\""), size_t(0));
+        EXPECT_NE(trace.find("\"kernel\":\"reluNaive_CPU\""), string::npos);
+
+        runtime->getProfiler().clear();
+        EXPECT_TRUE(runtime->getProfiler().getRecords().empty());
+    }
+
+    TEST(Runtime, RooflineReport)
+    {
+        auto runtime = make_ref<NativeCpuRuntimeObj>();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({64, 64});
+        auto b = g->addTensor({64, 64});
+        auto add = g->addOp<AddObj>(a, b, nullptr);
+        g->addOp<ReluObj>(add->getOutput(), nullptr);
+        g->dataMalloc();
+        runtime->setProfiling(true);
+        runtime->run(g);
+        runtime->setProfiling(false);
+
+        Roofline machine{100., 10.};
+        EXPECT_DOUBLE_EQ(machine.attainableGflops(1.), 10.);
+        EXPECT_DOUBLE_EQ(machine.attainableGflops(100.), 100.);
+        auto report = runtime->getProfiler().rooflineReport(machine);
+        EXPECT_NE(report.find("%Roof"), string::npos);
+        EXPECT_NE(report.find("Add"), string::npos);
+        EXPECT_NE(report.find("Relu"), string::npos);
+
+        auto probed = probeRoofline(runtime->getThreadPool(), 1 << 20);
+        EXPECT_GT(probed.peakGflops, 0.);
+        EXPECT_GT(probed.bandwidthGBs, 0.);
+    }
+
+    TEST(Runtime, HardwareCounters)
+    {
+        ThreadPoolConfig config;
+        config.numThreads = 2;
+        auto runtime = make_ref<NativeCpuRuntimeObj>(config);
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({256, 256});
+        g->addOp<ReluObj>(a, nullptr);
+        g->dataMalloc();
+        runtime->setProfiling(true);
+        runtime->setHardwareCounters(true);
+        runtime->run(g);
+
+        auto records = runtime->getProfiler().getRecords();
+        ASSERT_EQ(records.size(), size_t(1));
+        auto summary = runtime->getProfiler().summary();
+        PerfCounters probe;
+        if (probe.isAvailable())
+        {
+            EXPECT_TRUE(records[0].hasCounters);
+            EXPECT_GT(records[0].counters.instructions, uint64_t(0));
+            EXPECT_NE(summary.find("IPC"), string::npos);
+        }
+        else
+        {
+            // Falls back to timing only and reports why.
+            EXPECT_FALSE(records[0].hasCounters);
+            EXPECT_NE(summary.find("unavailable"), string::npos);
+        }
+    }
+
+} // namespace infini
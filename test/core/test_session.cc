@@ -0,0 +1,89 @@
+#include "core/runtime.h"
+#include "core/session.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+#include "utils/data_generator.h"
+
+#include "test.h"
+#include <thread>
+
+namespace infini
+{
+    TEST(Session, ConcurrentRunsShareWeights)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph model = make_ref<GraphObj>(runtime);
+        Tensor x = model->addTensor({1, 3, 4});
+        TensorVec outs;
+        for (int i = 0; i < 2; ++i)
+        {
+            Tensor w = model->addTensor({4, 5});
+            w->setConstant();
+            outs.emplace_back(
+                model->addOp<MatmulObj>(x, w, nullptr)->getOutput());
+        }
+        Tensor bias = model->addTensor(Shape{5});
+        bias->setConstant();
+        auto sub = model->addOp<SubObj>(outs[0], outs[1], nullptr);
+        auto add = model->addOp<AddObj>(sub->getOutput(), bias, nullptr);
+        Tensor out = model->addOp<ReluObj>(add->getOutput(), nullptr)
+                         ->getOutput();
+        model->optimize();
+        model->dataMalloc();
+        for (auto &input : model->getInputs())
+            input->setData(IncrementalGenerator());
+        model->foldConstants();
+        model->packConstants();
+
+        // Expected outputs per batch size, from the model itself.
+        constexpr int kSessions = 4;
+        vector<vector<float>> expected;
+        for (int batch = 1; batch <= kSessions; ++batch)
+        {
+            model->resize({x}, {{batch, 3, 4}});
+            x->setData(IncrementalGenerator());
+            runtime->run(model);
+            auto ptr = out->getRawDataPtr<float *>();
+            expected.emplace_back(ptr, ptr + out->size());
+        }
+
+        // Each thread copies the model itself, so the copies race as well.
+        vector<Session> sessions(kSessions);
+        vector<int> mismatches(kSessions);
+        vector<std::thread> threads;
+        for (int i = 0; i < kSessions; ++i)
+            threads.emplace_back(
+                [&, i]
+                {
+                    auto &session = sessions[i];
+                    session = make_ref<SessionObj>(model);
+                    Tensor input = session->getInputs()[0];
+                    session->resize({input}, {{i + 1, 3, 4}});
+                    Tensor output = session->getOutputs()[0];
+                    for (int iter = 0; iter < 50; ++iter)
+                    {
+                        input->setData(IncrementalGenerator());
+                        session->run();
+                        mismatches[i] += !output->equalData(expected[i]);
+                    }
+                });
+        for (auto &thread : threads)
+            thread.join();
+        EXPECT_EQ(mismatches, vector<int>(kSessions, 0));
+
+        vector<void *> weights;
+        for (auto &input : model->getInputs())
+            if (input->isConstant())
+                weights.emplace_back(input->getRawDataPtr<void *>());
+        for (auto &session : sessions)
+        {
+            vector<void *> shared;
+            for (auto &input : session->getGraph()->getInputs())
+                if (input->isConstant())
+                    shared.emplace_back(input->getRawDataPtr<void *>());
+            EXPECT_EQ(shared, weights);
+            EXPECT_EQ(session->getInputs().size(), 1u);
+        }
+    }
+} // namespace infini
@@ -0,0 +1,28 @@
+#include "core/runtime.h"
+#include "core/tensor.h"
+#include "utils/operator_utils.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(Tensor, SizeBeyondInt32)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        // Shapes only, nothing is allocated.
+        auto t = make_ref<TensorObj>(Shape{3, 65536, 65536}, DataType::Float32,
+                                     runtime);
+        EXPECT_EQ(t->size(), size_t(3) << 32);
+        EXPECT_EQ(t->getBytes(), size_t(3) << 34);
+        EXPECT_EQ(t->getStride(), (Stride{size_t(1) << 32, 65536, 1}));
+        t->setShape(Shape{65536, 65536});
+        EXPECT_EQ(t->size(), size_t(1) << 32);
+
+        size_t last = (size_t(3) << 32) - 1;
+        auto index = locate_index(last, Shape{3, 65536, 65536});
+        EXPECT_EQ(index, (Shape{2, 65535, 65535}));
+        EXPECT_EQ(delocate_index(index, Shape{3, 65536, 65536},
+                                 Stride{size_t(1) << 32, 65536, 1}),
+                  last);
+    }
+} // namespace infini
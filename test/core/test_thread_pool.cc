@@ -0,0 +1,141 @@
+#include "core/data_type.h"
+#include "core/thread_pool.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(ThreadPool, ParallelForCoversRange)
+    {
+        for (int spin : {0, 1000})
+        {
+            ThreadPoolConfig config;
+            config.numThreads = 4;
+            config.spinCount = spin;
+            ThreadPool pool(config);
+            EXPECT_EQ(pool.getNumThreads(), 4);
+            vector<int> hits(10007, 0);
+            for (int round = 0; round < 20; ++round)
+                pool.parallel_for(0, hits.size(), 16, [&](size_t b, size_t e)
+                                  {
+                    for (size_t i = b; i < e; ++i)
+                        hits[i]++; });
+            for (auto h : hits)
+                EXPECT_EQ(h, 20);
+        }
+    }
+
+    TEST(ThreadPool, ParallelReduceIsDeterministic)
+    {
+        ThreadPoolConfig config;
+        config.numThreads = 3;
+        ThreadPool pool(config);
+        auto sum = pool.parallel_reduce(
+            size_t(1), size_t(100001), 64, size_t(0),
+            [](size_t b, size_t e)
+            {
+                size_t s = 0;
+                for (size_t i = b; i < e; ++i)
+                    s += i;
+                return s;
+            },
+            [](size_t a, size_t b)
+            { return a + b; });
+        EXPECT_EQ(sum, size_t(100000) * 100001 / 2);
+        EXPECT_EQ(pool.parallel_reduce(
+                      size_t(5), size_t(5), 1, 7,
+                      [](size_t, size_t)
+                      { return 0; },
+                      [](int a, int b)
+                      { return a + b; }),
+                  7);
+    }
+
+    TEST(ThreadPool, NestedAndExceptions)
+    {
+        ThreadPoolConfig config;
+        config.numThreads = 4;
+        ThreadPool pool(config);
+        std::atomic<int> total{0};
+        pool.parallel_for(0, 8, 1, [&](size_t b, size_t e)
+                          {
+            for (size_t i = b; i < e; ++i)
+                pool.parallel_for(0, 100, 1, [&](size_t ib, size_t ie)
+                                  { total += ie - ib; }); });
+        EXPECT_EQ(total.load(), 800);
+        EXPECT_THROW(pool.parallel_for(0, 1000, 1, [](size_t b, size_t e)
+                                       { IT_ASSERT(b > 500 || e <= 500); }),
+                     Exception);
+        // The pool stays usable after a failed region.
+        total = 0;
+        pool.parallel_for(0, 1000, 1, [&](size_t b, size_t e)
+                          { total += e - b; });
+        EXPECT_EQ(total.load(), 1000);
+    }
+
+#ifdef __linux__
+    TEST(ThreadPool, BadAffinityThrows)
+    {
+        ThreadPoolConfig config;
+        config.numThreads = 4;
+        config.cpuAffinity = {0, -1};
+        EXPECT_THROW(ThreadPool pool(config), Exception);
+        // A valid id of a CPU that does not exist fails once workers run.
+        config.cpuAffinity = {CPU_SETSIZE - 1};
+        EXPECT_THROW(ThreadPool pool(config), Exception);
+    }
+#endif
+
+    TEST(ThreadPool, ConcurrencyLimit)
+    {
+        ThreadPoolConfig config;
+        config.numThreads = 4;
+        ThreadPool pool(config);
+        auto caller = std::this_thread::get_id();
+        {
+            ThreadPool::ConcurrencyLimit limit(1);
+            bool inline_ = true;
+            pool.parallel_for(0, 1 << 16, 1, [&](size_t, size_t)
+                              { inline_ &= std::this_thread::get_id() == caller; });
+            EXPECT_TRUE(inline_);
+            {
+                // Inner guards can only tighten the limit.
+                ThreadPool::ConcurrencyLimit wider(4);
+                size_t calls = 0;
+                pool.parallel_for(0, 1 << 16, 1, [&](size_t, size_t)
+                                  { ++calls; });
+                EXPECT_EQ(calls, size_t(1));
+            }
+        }
+        std::mutex mtx;
+        std::set<std::thread::id> ids;
+        {
+            ThreadPool::ConcurrencyLimit limit(2);
+            for (int round = 0; round < 10; ++round)
+                pool.parallel_for(0, 1 << 12, 1, [&](size_t, size_t)
+                                  {
+                    std::lock_guard<std::mutex> lk(mtx);
+                    ids.insert(std::this_thread::get_id()); });
+        }
+        EXPECT_LE(ids.size(), size_t(2));
+    }
+
+    TEST(ThreadPool, ConcurrentSubmitters)
+    {
+        ThreadPoolConfig config;
+        config.numThreads = 2;
+        ThreadPool pool(config);
+        std::atomic<size_t> total{0};
+        vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+            threads.emplace_back([&]
+                                 {
+                for (int r = 0; r < 50; ++r)
+                    pool.parallel_for(0, 4096, 64, [&](size_t b, size_t e)
+                                      { total += e - b; }); });
+        for (auto &t : threads)
+            t.join();
+        EXPECT_EQ(total.load(), size_t(4) * 50 * 4096);
+    }
+
+} // namespace infini
@@ -0,0 +1,25 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini {
+
+TEST(Cast, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto input = g->addTensor({2, 3}, DataType::Float32);
+    auto toInt = g->addOp<CastObj>(input, nullptr, CastType::Float2Int32);
+    auto toFloat =
+        g->addOp<CastObj>(toInt->getOutput(), nullptr, CastType::Int322Float);
+    g->dataMalloc();
+    input->setData(IncrementalGenerator());
+
+    runtime->run(g);
+    EXPECT_TRUE(toInt->getOutput()->equalData(vector<int32_t>{0, 1, 2, 3, 4, 5}));
+    EXPECT_TRUE(
+        toFloat->getOutput()->equalData(vector<float>{0, 1, 2, 3, 4, 5}));
+}
+
+} // namespace infini
@@ -0,0 +1,42 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/fused_element_wise.h"
+
+#include "test.h"
+
+namespace infini {
+
+TEST(FusedElementWise, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto a = g->addTensor({2, 3}, DataType::Float32);
+    auto b = g->addTensor({3}, DataType::Float32);
+    // Cast(Clip(Mul(Relu(a - b), a), max=10)) to int32.
+    vector<FusedStep> steps(5);
+    steps[0].type = OpType::Sub;
+    steps[0].args[0] = 0;
+    steps[0].args[1] = 1;
+    steps[1].type = OpType::Relu;
+    steps[1].args[0] = 2;
+    steps[2].type = OpType::Mul;
+    steps[2].args[0] = 3;
+    steps[2].args[1] = 0;
+    steps[3].type = OpType::Clip;
+    steps[3].args[0] = 4;
+    steps[3].max = 10.f;
+    steps[4].type = OpType::Cast;
+    steps[4].args[0] = 5;
+    steps[4].dtype = DataType::Int32;
+    auto op = g->addOp<FusedElementWiseObj>(TensorVec{a, b}, nullptr, steps);
+    EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3}));
+    EXPECT_EQ(op->getOutDType(), DataType::Int32);
+    g->dataMalloc();
+    a->setData(IncrementalGenerator());
+    b->setData(IncrementalGenerator());
+
+    runtime->run(g);
+    EXPECT_TRUE(
+        op->getOutput()->equalData(vector<int32_t>{0, 0, 0, 9, 10, 10}));
+}
+
+} // namespace infini
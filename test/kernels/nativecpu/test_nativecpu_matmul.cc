@@ -0,0 +1,100 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+
+#include "test.h"
+
+namespace infini {
+
+void testMatmulNativeCpu(const Shape &shapeA, const Shape &shapeB, bool transA,
+                         bool transB, const vector<float> &ansVec) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto a = g->addTensor(shapeA, DataType::Float32);
+    auto b = g->addTensor(shapeB, DataType::Float32);
+    auto op = g->addOp<MatmulObj>(a, b, nullptr, transA, transB);
+    g->dataMalloc();
+    a->setData(IncrementalGenerator());
+    b->setData(IncrementalGenerator());
+
+    runtime->run(g);
+    EXPECT_TRUE(op->getOutput()->equalData(ansVec));
+}
+
+TEST(Matmul, NativeCpu) {
+    // [[0,1,2],[3,4,5]] x [[0,1],[2,3],[4,5]]
+    testMatmulNativeCpu(Shape{2, 3}, Shape{3, 2}, false, false,
+                        vector<float>{10, 13, 28, 40});
+    // A^T with A = [[0,1],[2,3],[4,5]], B^T with B = [[0,1,2],[3,4,5]]
+    testMatmulNativeCpu(Shape{3, 2}, Shape{2, 3}, true, true,
+                        vector<float>{10, 28, 13, 40});
+    // The single batch of B is broadcast to both batches of A.
+    testMatmulNativeCpu(Shape{2, 1, 2}, Shape{1, 2, 2}, false, false,
+                        vector<float>{2, 3, 6, 11});
+}
+
+TEST(Matmul, NativeCpuEpilogue) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto a = g->addTensor({2, 3}, DataType::Float32);
+    auto b = g->addTensor({3, 2}, DataType::Float32);
+    auto bias = g->addTensor({2}, DataType::Float32);
+    // Cast(Clip(C - bias, max=30)) to int32.
+    vector<FusedStep> epilogue(3);
+    epilogue[0].type = OpType::Sub;
+    epilogue[0].args[0] = 0;
+    epilogue[0].args[1] = 1;
+    epilogue[1].type = OpType::Clip;
+    epilogue[1].args[0] = 2;
+    epilogue[1].max = 30.f;
+    epilogue[2].type = OpType::Cast;
+    epilogue[2].args[0] = 3;
+    epilogue[2].dtype = DataType::Int32;
+    auto op = g->addOp<MatmulObj>(a, b, nullptr, false, false,
+                                  TensorVec{bias}, epilogue);
+    EXPECT_EQ(op->getOutDType(), DataType::Int32);
+    g->dataMalloc();
+    a->setData(IncrementalGenerator());
+    b->setData(IncrementalGenerator());
+    bias->setData(IncrementalGenerator());
+
+    runtime->run(g);
+    EXPECT_TRUE(op->getOutput()->equalData(vector<int32_t>{10, 12, 28, 30}));
+}
+
+TEST(Matmul, NativeCpuPackedWeight) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    // N = 70 leaves a narrow last panel; the epilogue adds a bias.
+    for (bool transB : {false, true}) {
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor(Shape{2, 3, 5}, DataType::Float32);
+        auto b = g->addTensor(transB ? Shape{2, 70, 5} : Shape{2, 5, 70},
+                              DataType::Float32);
+        auto bias = g->addTensor(Shape{70}, DataType::Float32);
+        vector<FusedStep> epilogue(1);
+        epilogue[0].type = OpType::Add;
+        epilogue[0].args[0] = 0;
+        epilogue[0].args[1] = 1;
+        auto plain = g->addOp<MatmulObj>(a, b, nullptr, false, transB,
+                                         TensorVec{bias}, epilogue);
+        auto wb = g->addTensor(b->getDims(), DataType::Float32);
+        wb->setConstant();
+        auto packed = g->addOp<MatmulObj>(a, wb, nullptr, false, transB,
+                                          TensorVec{bias}, epilogue);
+        g->dataMalloc();
+        a->setData(IncrementalGenerator());
+        b->setData(IncrementalGenerator());
+        wb->setData(IncrementalGenerator());
+        bias->setData(IncrementalGenerator());
+
+        EXPECT_EQ(g->packConstants(), 1);
+        EXPECT_GT(packed->getPackedB(), 0);
+        EXPECT_EQ(plain->getPackedB(), 0);
+        EXPECT_FALSE(wb->equalData(b));
+        EXPECT_EQ(g->packConstants(), 0);
+        runtime->run(g);
+        EXPECT_TRUE(packed->getOutput()->equalData(plain->getOutput()));
+    }
+}
+
+} // namespace infini
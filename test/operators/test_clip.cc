@@ -20,4 +20,16 @@ namespace infini {
         EXPECT_EQ(op->getOutDType(), (DataType::Float32));
     }
 
+    TEST(Clip, Cost)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i0 = g->addTensor({1, 2, 2, 3}, DataType::Float32);
+        auto both = g->addOp<ClipObj>(i0, nullptr, 1.f, 4.f);
+        auto lower = g->addOp<ClipObj>(i0, nullptr, 1.f, std::nullopt);
+        EXPECT_EQ(both->getCost().flops, size_t(24));
+        EXPECT_EQ(lower->getCost().flops, size_t(12));
+        EXPECT_EQ(lower->getCost().bytes, size_t(24 * sizeof(float)));
+    }
+
 } // namespace infini
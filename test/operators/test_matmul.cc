@@ -54,4 +54,16 @@ namespace infini
         }
     }
 
+    TEST(Matmul, Cost)
+    {
+        auto runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto A = g->addTensor(Shape{2, 3, 5, 4});
+        auto B = g->addTensor(Shape{1, 3, 5, 2});
+        auto matmul = g->addOp<MatmulObj>(A, B, nullptr, true, false);
+        auto cost = matmul->getCost();
+        EXPECT_EQ(cost.flops, size_t(2 * 2 * 3 * 4 * 2 * 5));
+        EXPECT_EQ(cost.bytes, (size_t)(120 + 30 + 48) * sizeof(float));
+    }
+
 }; // namespace infini
\ No newline at end of file
@@ -29,4 +29,13 @@ TEST(Transpose, ShapeInference) {
     }
 }
 
+TEST(Transpose, Cost) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    Tensor i = g->addTensor({1, 2, 3, 4}, DataType::Float32);
+    auto op = g->addOp<TransposeObj>(i, nullptr, Shape{0, 1, 3, 2});
+    EXPECT_EQ(op->getCost().flops, size_t(0));
+    EXPECT_EQ(op->getCost().bytes, size_t(2 * 24 * sizeof(float)));
+}
+
 } // namespace infini